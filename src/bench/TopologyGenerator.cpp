@@ -0,0 +1,228 @@
+#include "bench/TopologyGenerator.h"
+#include "models/Network.h"
+#include "utils/IpUtils.h"
+#include <QHash>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+
+// ---------------------------------------------------------------------------
+// Builder: hands out interfaces and addresses while wiring routers together
+// ---------------------------------------------------------------------------
+namespace {
+
+class Builder
+{
+public:
+    Builder(Network *net, Router::RoutingProtocol protocol) : m_net(net), m_protocol(protocol) {}
+
+    Router *router(qreal x, qreal y)
+    {
+        auto *r = new Router(QString("R%1").arg(++m_routers), m_net);
+        r->setRoutingProtocol(m_protocol);
+        r->setPosition(x, y);
+        if (m_protocol == Router::RoutingProtocol::OSPF)
+            r->ospfConfig().routerId = IpUtils::format(quint32(m_routers));
+        m_net->addDevice(r);
+        return r;
+    }
+
+    void link(Router *a, Router *b)
+    {
+        const quint32 subnet = m_nextLink;
+        m_nextLink += 4;
+        const QString ifA = nextInterface(a, subnet + 1, 0xFFFFFFFCu);
+        const QString ifB = nextInterface(b, subnet + 2, 0xFFFFFFFCu);
+        m_net->addLink({QString("L%1").arg(++m_links), a->id(), ifA, b->id(), ifB});
+    }
+
+    void lan(Router *r)
+    {
+        const quint32 subnet = m_nextLan;
+        m_nextLan += 256;
+        const QString ifR = nextInterface(r, subnet + 1, 0xFFFFFF00u);
+
+        auto *pc = new PC(QString("PC%1").arg(++m_pcs), m_net);
+        pc->setPosition(r->x(), r->y() + 60);
+        pc->interfaces()[0].setAddress(subnet + 10, 0xFFFFFF00u);
+        pc->setDefaultGateway(IpUtils::format(subnet + 1));
+        m_net->addDevice(pc);
+        m_net->addLink({QString("L%1").arg(++m_links), r->id(), ifR, pc->id(), "eth0"});
+    }
+
+private:
+    // Next unused interface on 'r' (growing the router past Gi0/3 as needed).
+    // The router is already in the network, so the address goes through the
+    // device to reach the address index.
+    QString nextInterface(Router *r, quint32 ip, quint32 mask)
+    {
+        const int index = m_used[r]++;
+        if (index >= r->interfaces().size())
+            r->addInterface(QString("Gi0/%1").arg(index));
+        const QString name = r->interfaces()[index].name;
+        r->setInterfaceAddress(name, ip, mask);
+        return name;
+    }
+
+    Network                *m_net;
+    Router::RoutingProtocol m_protocol;
+    QHash<Router *, int>    m_used;
+    quint32 m_nextLink = 0x0A000000u; // 10.0.0.0
+    quint32 m_nextLan  = 0x64400000u; // 100.64.0.0
+    int     m_routers  = 0;
+    int     m_pcs      = 0;
+    int     m_links    = 0;
+};
+
+constexpr qreal SPACING = 120.0;
+constexpr qreal PI      = 3.14159265358979323846;
+
+void buildRing(Builder &b, int n, QList<Router *> &edge)
+{
+    const qreal radius = SPACING * n / (2 * PI);
+    QList<Router *> rs;
+    for (int i = 0; i < n; ++i)
+        rs.append(b.router(radius * std::cos(2 * PI * i / n), radius * std::sin(2 * PI * i / n)));
+    for (int i = 0; i < n && n > 1; ++i)
+        if (n > 2 || i == 0) b.link(rs[i], rs[(i + 1) % n]);
+    edge = rs;
+}
+
+void buildGrid(Builder &b, int n, QList<Router *> &edge)
+{
+    const int w = std::max(1, int(std::ceil(std::sqrt(qreal(n)))));
+    QList<Router *> rs;
+    for (int i = 0; i < n; ++i)
+        rs.append(b.router((i % w) * SPACING, (i / w) * SPACING));
+    for (int i = 0; i < n; ++i) {
+        if (i % w + 1 < w && i + 1 < n) b.link(rs[i], rs[i + 1]);
+        if (i + w < n)                  b.link(rs[i], rs[i + w]);
+    }
+    edge = rs;
+}
+
+// k-ary fat tree: (k/2)^2 core, and k pods of k/2 aggregation + k/2 edge
+// switches-as-routers; 5k^2/4 routers in all, so k is the smallest even
+// value reaching n.
+void buildFatTree(Builder &b, int n, QList<Router *> &edge)
+{
+    int k = 2;
+    while (5 * k * k / 4 < n) k += 2;
+    const int half = k / 2;
+
+    QList<Router *> core;
+    for (int i = 0; i < half * half; ++i)
+        core.append(b.router((i - half * half / 2.0) * SPACING, 0));
+
+    for (int p = 0; p < k; ++p) {
+        const qreal podX = (p - k / 2.0) * half * SPACING;
+        QList<Router *> agg, edg;
+        for (int i = 0; i < half; ++i) agg.append(b.router(podX + i * SPACING, 2 * SPACING));
+        for (int i = 0; i < half; ++i) edg.append(b.router(podX + i * SPACING, 4 * SPACING));
+        for (int a = 0; a < half; ++a) {
+            for (int c = 0; c < half; ++c) b.link(agg[a], core[a * half + c]);
+            for (int e = 0; e < half; ++e) b.link(agg[a], edg[e]);
+        }
+        edge += edg;
+    }
+}
+
+// Uniform points in a square, linked when closer than the radius giving an
+// average degree of about six.  A spatial hash keeps this O(n).
+void buildRandomGeometric(Builder &b, int n, quint32 seed, QList<Router *> &edge)
+{
+    QRandomGenerator rng(seed);
+    const qreal side   = SPACING * std::sqrt(qreal(n));
+    const qreal radius = side * std::sqrt(6.0 / (PI * std::max(n, 1)));
+
+    QList<Router *> rs;
+    QHash<quint64, QList<int>> cells;
+    auto cellKey = [radius](qreal x, qreal y) {
+        return (quint64(quint32(qint32(std::floor(x / radius)))) << 32) |
+               quint32(qint32(std::floor(y / radius)));
+    };
+    for (int i = 0; i < n; ++i) {
+        const qreal x = rng.generateDouble() * side;
+        const qreal y = rng.generateDouble() * side;
+        rs.append(b.router(x, y));
+        cells[cellKey(x, y)].append(i);
+    }
+
+    for (int i = 0; i < n; ++i) {
+        const qreal x = rs[i]->x(), y = rs[i]->y();
+        for (int dx = -1; dx <= 1; ++dx)
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int j : cells.value(cellKey(x + dx * radius, y + dy * radius)))
+                    if (j > i && std::hypot(rs[j]->x() - x, rs[j]->y() - y) < radius)
+                        b.link(rs[i], rs[j]);
+    }
+    edge = rs;
+}
+
+// ISP-like hierarchy: a meshed core (~1%), aggregation routers (~10%) each
+// dual-homed to two core routers, and access routers single-homed to an
+// aggregation router.
+void buildIsp(Builder &b, int n, QList<Router *> &edge)
+{
+    const int coreCount = std::clamp(n / 100, std::min(n, 4), 64);
+    const int aggCount  = std::min(n - coreCount, std::max(1, n / 10));
+    const int accCount  = n - coreCount - aggCount;
+
+    QList<Router *> core, agg;
+    for (int i = 0; i < coreCount; ++i)
+        core.append(b.router(i * 2 * SPACING, 0));
+    for (int i = 0; i < coreCount; ++i)
+        for (int j = i + 1; j < coreCount; ++j)
+            if (coreCount <= 8 || j == i + 1 || j == i + coreCount / 2)
+                b.link(core[i], core[j]); // full mesh when small, else ring + chords
+
+    for (int i = 0; i < aggCount; ++i) {
+        agg.append(b.router(i * SPACING, 3 * SPACING));
+        if (coreCount > 0) {
+            b.link(agg[i], core[i % coreCount]);
+            if (coreCount > 1) b.link(agg[i], core[(i + 1) % coreCount]);
+        }
+    }
+    for (int i = 0; i < accCount; ++i) {
+        Router *r = b.router((i / 4) * SPACING, 6 * SPACING + (i % 4) * 40);
+        if (aggCount > 0) b.link(r, agg[i % aggCount]);
+        edge.append(r);
+    }
+    if (edge.isEmpty()) edge = agg.isEmpty() ? core : agg;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+Network *TopologyGenerator::generate(const Options &options, QObject *parent)
+{
+    auto *net = new Network(parent);
+    net->setName(QString("%1-%2").arg(shapeName(options.shape)).arg(options.routers));
+
+    Builder b(net, options.protocol);
+    QList<Router *> edge;
+    const int n = std::max(1, options.routers);
+    switch (options.shape) {
+        case Shape::Ring:            buildRing(b, n, edge);                          break;
+        case Shape::Grid:            buildGrid(b, n, edge);                          break;
+        case Shape::FatTree:         buildFatTree(b, n, edge);                       break;
+        case Shape::RandomGeometric: buildRandomGeometric(b, n, options.seed, edge); break;
+        case Shape::Isp:             buildIsp(b, n, edge);                           break;
+    }
+
+    if (options.lanPcs)
+        for (Router *r : edge) b.lan(r);
+    return net;
+}
+
+QString TopologyGenerator::shapeName(Shape shape)
+{
+    switch (shape) {
+        case Shape::Ring:            return "ring";
+        case Shape::Grid:            return "grid";
+        case Shape::FatTree:         return "fat-tree";
+        case Shape::RandomGeometric: return "random-geometric";
+        case Shape::Isp:             return "isp";
+    }
+    return {};
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <QString>
+#include "models/Device.h"
+
+class Network;
+class QObject;
+
+// ---------------------------------------------------------------------------
+// TopologyGenerator
+//
+// Deterministic synthetic networks for benchmarking.  Every generator builds
+// about 'routers' routers running 'protocol', numbers each router-router link
+// from 10.0.0.0/8 in /30s and, with 'lanPcs', gives every router (or every
+// edge router, where the shape has edges) a /24 LAN with one PC from
+// 100.64.0.0/10.  Positions are set so the canvas shows the shape.
+// ---------------------------------------------------------------------------
+class TopologyGenerator
+{
+public:
+    enum class Shape { Ring, Grid, FatTree, RandomGeometric, Isp };
+
+    struct Options {
+        Shape                   shape    = Shape::Ring;
+        int                     routers  = 100;
+        Router::RoutingProtocol protocol = Router::RoutingProtocol::OSPF;
+        bool                    lanPcs   = false;
+        quint32                 seed     = 1;  // RandomGeometric placement
+    };
+
+    static Network *generate(const Options &options, QObject *parent = nullptr);
+
+    static QString shapeName(Shape shape);
+};
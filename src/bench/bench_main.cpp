@@ -0,0 +1,276 @@
+// ---------------------------------------------------------------------------
+// NetworkEmulator benchmarks
+//
+// Google Benchmark suite over synthetic topologies (see TopologyGenerator).
+// Output defaults to JSON on stdout; pass --benchmark_format=console for a
+// table, or --benchmark_out=<file> to keep a copy for regression tracking.
+// Run with --benchmark_filter=<regex> to select, e.g. 'Routing/.*/1000/'.
+// NETEMU_BENCH_LARGE_ROUTING=1 adds 10k-router routing runs (see below).
+// ---------------------------------------------------------------------------
+#include <benchmark/benchmark.h>
+
+#include <QApplication>
+#include <QTemporaryDir>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench/TopologyGenerator.h"
+#include "models/Network.h"
+#include "models/DeviceStore.h"
+#include "routing/RoutingEngine.h"
+#include "routing/WhatIfSweep.h"
+#include "validation/Validator.h"
+#include "gui/NetworkCanvas.h"
+
+using Shape = TopologyGenerator::Shape;
+
+static const std::vector<int64_t> SHAPES = {
+    int64_t(Shape::Ring), int64_t(Shape::Grid), int64_t(Shape::FatTree),
+    int64_t(Shape::RandomGeometric), int64_t(Shape::Isp)};
+
+// Routing fills all-pairs tables, about n^2 rows: 2k routers is ~4M rows,
+// 10k is ~10^8 rows and tens of GB, so 10k runs only when
+// NETEMU_BENCH_LARGE_ROUTING is set.  Model and canvas operations go to 100k.
+static std::vector<int64_t> routingSizes()
+{
+    std::vector<int64_t> sizes = {100, 1000, 2000};
+    if (qEnvironmentVariableIntValue("NETEMU_BENCH_LARGE_ROUTING") > 0)
+        sizes.push_back(10000);
+    return sizes;
+}
+
+static const std::vector<int64_t> ROUTING_SIZES = routingSizes();
+static const std::vector<int64_t> MODEL_SIZES   = {100, 1000, 10000, 100000};
+
+static std::unique_ptr<Network> makeNetwork(const benchmark::State &state,
+                                            Router::RoutingProtocol protocol,
+                                            bool lanPcs = true)
+{
+    TopologyGenerator::Options opts;
+    opts.routers  = static_cast<int>(state.range(0));
+    opts.shape    = static_cast<Shape>(state.range(1));
+    opts.protocol = protocol;
+    opts.lanPcs   = lanPcs;
+    return std::unique_ptr<Network>(TopologyGenerator::generate(opts));
+}
+
+static void setTopologyCounters(benchmark::State &state, const Network &net)
+{
+    state.SetLabel(TopologyGenerator::shapeName(static_cast<Shape>(state.range(1))).toStdString());
+    state.counters["devices"] = static_cast<double>(net.devices().size());
+    state.counters["links"]   = static_cast<double>(net.links().size());
+}
+
+// ---------------------------------------------------------------------------
+// Routing
+// ---------------------------------------------------------------------------
+static void BM_Routing(benchmark::State &state)
+{
+    const auto protocol = static_cast<Router::RoutingProtocol>(state.range(2));
+    auto net = makeNetwork(state, protocol);
+
+    SimulationStats stats;
+    for (auto _ : state) {
+        const SimulationResult result = RoutingEngine::run(net.get());
+        stats = result.stats;
+        benchmark::DoNotOptimize(stats);
+    }
+    setTopologyCounters(state, *net);
+    state.counters["routes"]         = static_cast<double>(stats.routesInstalled);
+    state.counters["rip_iterations"] = stats.ripIterations;
+    state.counters["spf_runs"]       = stats.spfRuns;
+    state.counters["heap_ops"]       = static_cast<double>(stats.heapOps);
+    state.counters["peak_rss_kb"]    = static_cast<double>(stats.peakRssKb);
+}
+BENCHMARK(BM_Routing)
+    ->Name("Routing")
+    ->ArgNames({"routers", "shape", "protocol"})
+    ->ArgsProduct({ROUTING_SIZES, SHAPES,
+                   {int64_t(Router::RoutingProtocol::Static),
+                    int64_t(Router::RoutingProtocol::RIPv2),
+                    int64_t(Router::RoutingProtocol::OSPF)}})
+    ->Unit(benchmark::kMillisecond);
+
+// Sweep-style reruns: one result refilled in place while a baseline is held
+static void BM_RoutingRerun(benchmark::State &state)
+{
+    const auto protocol = static_cast<Router::RoutingProtocol>(state.range(2));
+    auto net = makeNetwork(state, protocol);
+
+    SimulationResult result;
+    RoutingEngine::run(net.get(), {}, result);
+    const SimulationResult baseline = result;
+    for (auto _ : state) {
+        RoutingEngine::run(net.get(), {}, result);
+        benchmark::DoNotOptimize(result);
+    }
+    setTopologyCounters(state, *net);
+    state.counters["routes"] = static_cast<double>(result.stats.routesInstalled);
+}
+BENCHMARK(BM_RoutingRerun)
+    ->Name("RoutingRerun")
+    ->ArgNames({"routers", "shape", "protocol"})
+    ->ArgsProduct({ROUTING_SIZES, SHAPES,
+                   {int64_t(Router::RoutingProtocol::RIPv2),
+                    int64_t(Router::RoutingProtocol::OSPF)}})
+    ->Unit(benchmark::kMillisecond);
+
+// N-1: every link failing on its own, diffed against the baseline
+static void BM_WhatIfLinkFailures(benchmark::State &state)
+{
+    auto net = makeNetwork(state, Router::RoutingProtocol::OSPF, false);
+    const QList<WhatIfScenario> scenarios = WhatIfSweep::linkFailures(net.get());
+
+    qint64 spfRuns = 0;
+    for (auto _ : state) {
+        const WhatIfResult result = WhatIfSweep::run(net.get(), scenarios);
+        spfRuns = 0;
+        for (const WhatIfOutcome &o : result.outcomes) spfRuns += o.spfRuns;
+        benchmark::DoNotOptimize(spfRuns);
+    }
+    setTopologyCounters(state, *net);
+    state.counters["scenarios"] = static_cast<double>(scenarios.size());
+    state.counters["spf_runs"]  = static_cast<double>(spfRuns);
+}
+BENCHMARK(BM_WhatIfLinkFailures)
+    ->Name("WhatIfLinkFailures")
+    ->ArgNames({"routers", "shape"})
+    ->ArgsProduct({{100, 1000}, SHAPES})
+    ->Unit(benchmark::kMillisecond);
+
+// ---------------------------------------------------------------------------
+// Validation
+// ---------------------------------------------------------------------------
+static void BM_Validate(benchmark::State &state)
+{
+    auto net = makeNetwork(state, Router::RoutingProtocol::OSPF);
+    for (auto _ : state) {
+        QList<ValidationIssue> issues = Validator::validate(net.get());
+        benchmark::DoNotOptimize(issues);
+    }
+    setTopologyCounters(state, *net);
+}
+BENCHMARK(BM_Validate)
+    ->Name("Validate")
+    ->ArgNames({"routers", "shape"})
+    ->ArgsProduct({MODEL_SIZES, SHAPES})
+    ->Unit(benchmark::kMillisecond);
+
+// ---------------------------------------------------------------------------
+// Persistence
+// ---------------------------------------------------------------------------
+static void BM_Save(benchmark::State &state)
+{
+    auto net = makeNetwork(state, Router::RoutingProtocol::OSPF);
+    QTemporaryDir dir;
+    const QString path = dir.filePath("bench.net");
+    for (auto _ : state)
+        net->save(path);
+    setTopologyCounters(state, *net);
+}
+BENCHMARK(BM_Save)
+    ->Name("Save")
+    ->ArgNames({"routers", "shape"})
+    ->ArgsProduct({MODEL_SIZES, SHAPES})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_Load(benchmark::State &state)
+{
+    auto net = makeNetwork(state, Router::RoutingProtocol::OSPF);
+    QTemporaryDir dir;
+    const QString path = dir.filePath("bench.net");
+    net->save(path);
+
+    Network loaded;
+    for (auto _ : state)
+        loaded.load(path);
+    setTopologyCounters(state, loaded);
+}
+BENCHMARK(BM_Load)
+    ->Name("Load")
+    ->ArgNames({"routers", "shape"})
+    ->ArgsProduct({MODEL_SIZES, SHAPES})
+    ->Unit(benchmark::kMillisecond);
+
+// The same file into the column store: no QObject per device
+static void BM_StoreLoad(benchmark::State &state)
+{
+    auto net = makeNetwork(state, Router::RoutingProtocol::OSPF);
+    QTemporaryDir dir;
+    const QString path = dir.filePath("bench.net");
+    net->save(path);
+
+    DeviceStore store;
+    for (auto _ : state)
+        store.load(path);
+    setTopologyCounters(state, *net);
+}
+BENCHMARK(BM_StoreLoad)
+    ->Name("StoreLoad")
+    ->ArgNames({"routers", "shape"})
+    ->ArgsProduct({MODEL_SIZES, SHAPES})
+    ->Unit(benchmark::kMillisecond);
+
+// ---------------------------------------------------------------------------
+// Canvas: building the scene for a network, and re-syncing it after a reload
+// of the same file (items are reused by id)
+// ---------------------------------------------------------------------------
+static void BM_CanvasBuild(benchmark::State &state)
+{
+    auto net = makeNetwork(state, Router::RoutingProtocol::OSPF);
+    for (auto _ : state) {
+        NetworkCanvas canvas(net.get());
+        benchmark::ClobberMemory();
+    }
+    setTopologyCounters(state, *net);
+}
+BENCHMARK(BM_CanvasBuild)
+    ->Name("CanvasBuild")
+    ->ArgNames({"routers", "shape"})
+    ->ArgsProduct({MODEL_SIZES, SHAPES})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_CanvasReload(benchmark::State &state)
+{
+    auto net = makeNetwork(state, Router::RoutingProtocol::OSPF);
+    QTemporaryDir dir;
+    const QString path = dir.filePath("bench.net");
+    net->save(path);
+    NetworkCanvas canvas(net.get());
+
+    for (auto _ : state)
+        net->load(path); // reset() -> NetworkCanvas::syncWithNetwork
+    setTopologyCounters(state, *net);
+}
+BENCHMARK(BM_CanvasReload)
+    ->Name("CanvasReload")
+    ->ArgNames({"routers", "shape"})
+    ->ArgsProduct({MODEL_SIZES, SHAPES})
+    ->Unit(benchmark::kMillisecond);
+
+// ---------------------------------------------------------------------------
+// Entry point
+// ---------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    // The canvas benchmarks need a QApplication, but no display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    // Machine-readable by default
+    std::vector<char *> args(argv, argv + argc);
+    bool formatGiven = false;
+    for (int i = 1; i < argc; ++i)
+        if (std::string(argv[i]).rfind("--benchmark_format", 0) == 0) formatGiven = true;
+    std::string jsonFormat = "--benchmark_format=json";
+    if (!formatGiven) args.push_back(jsonFormat.data());
+
+    int benchArgc = static_cast<int>(args.size());
+    benchmark::Initialize(&benchArgc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(benchArgc, args.data())) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -18,6 +18,9 @@
 #include <QMenu>
 #include <QAction>
 #include <QStyleOptionGraphicsItem>
+#include <QPixmapCache>
+#include <QTextOption>
+#include <QtMath>
 
 DeviceItem::DeviceItem(Device *device, QGraphicsItem *parent)
     : QGraphicsObject(parent)
@@ -26,6 +29,16 @@ DeviceItem::DeviceItem(Device *device, QGraphicsItem *parent)
     setFlags(ItemIsMovable | ItemIsSelectable | ItemSendsGeometryChanges);
     setZValue(1);
     setToolTip(device->name());
+    layoutName();
+}
+
+void DeviceItem::setDevice(Device *device)
+{
+    m_device = device;
+    setToolTip(device->name());
+    layoutName();
+    setPos(device->x(), device->y());
+    update();
 }
 
 void DeviceItem::addLink(LinkItem *link)    { m_links.append(link); }
@@ -36,38 +49,127 @@ QRectF DeviceItem::boundingRect() const
     const qreal half = SIZE / 2.0;
     // Ring drawn at -half-4 with a 2.5px pen (1.25px bleed) → need ≥6px margin.
     // Extra 20px below for the name label.
-    const qreal m = 6.0;
+    const qreal m = ICON_MARGIN;
     return QRectF(-half - m, -half - m, SIZE + 2 * m, SIZE + 2 * m + 20);
 }
 
 void DeviceItem::paint(QPainter *painter,
-                       const QStyleOptionGraphicsItem * /*option*/,
+                       const QStyleOptionGraphicsItem *option,
                        QWidget * /*widget*/)
 {
-    painter->setRenderHint(QPainter::Antialiasing);
-    const qreal half = SIZE / 2.0;
+    const qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+    if (lod < LOD_CLUSTER) return; // NetworkCanvas::drawForeground draws clusters
+    if (lod < LOD_DETAIL) {
+        drawGlyph(painter);
+        return;
+    }
+
+    // Icon (with any selection/highlight ring) comes from the shared pixmap
+    // cache, rasterised at the current zoom times device pixel ratio
+    const Ring  ring  = m_highlighted ? Ring::Highlighted
+                      : isSelected()  ? Ring::Selected : Ring::None;
+    const qreal dpr   = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const QPixmap icon = cachedIcon(m_device->deviceType(), ring, lod * dpr);
+    const qreal extent = SIZE / 2.0 + ICON_MARGIN;
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    painter->drawPixmap(QPointF(-extent, -extent), icon);
+
+    // Device name label below icon
+    painter->setPen(Qt::black);
+    painter->setFont(nameFont());
+    const qreal top = SIZE / 2.0 + 3 + (18 - m_nameText.size().height()) / 2;
+    painter->drawStaticText(QPointF(-40, top), m_nameText);
+}
+
+// Lays out the name label once; redone only when the device (name) changes.
+void DeviceItem::layoutName()
+{
+    m_nameText.setText(m_device->name());
+    m_nameText.setTextWidth(80);
+    m_nameText.setTextOption(QTextOption(Qt::AlignHCenter));
+    m_nameText.prepare(QTransform(), nameFont());
+}
+
+const QFont &DeviceItem::nameFont()
+{
+    static const QFont font("Arial", 8);
+    return font;
+}
+
+// ---------------------------------------------------------------------------
+// Icon cache: one pixmap per (type, ring, raster scale) in QPixmapCache,
+// shared by every DeviceItem.  Scales snap to powers of two so zooming
+// reuses a handful of entries; the view's transform covers the rest.
+// ---------------------------------------------------------------------------
+QPixmap DeviceItem::cachedIcon(Device::Type type, Ring ring, qreal scale)
+{
+    qreal snapped = 1.0;
+    while (snapped < scale && snapped < 8.0) snapped *= 2.0;
+
+    const QString key = QString("device-icon/%1/%2/%3")
+                            .arg(static_cast<int>(type)).arg(static_cast<int>(ring)).arg(snapped);
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap)) return pixmap;
+
+    const qreal extent = SIZE / 2.0 + ICON_MARGIN;
+    const int   px     = qCeil(2 * extent * snapped);
+    pixmap = QPixmap(px, px);
+    pixmap.setDevicePixelRatio(snapped);
+    pixmap.fill(Qt::transparent);
+
+    QPainter p(&pixmap);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.translate(extent, extent);
 
     // Selection / highlight ring drawn behind the icon
-    if (isSelected() || m_highlighted) {
-        const QColor ringColor = m_highlighted ? QColor(255, 215, 0) : QColor(30, 160, 255);
+    if (ring != Ring::None) {
+        const qreal half = SIZE / 2.0;
+        const QColor ringColor = ring == Ring::Highlighted ? QColor(255, 215, 0) : QColor(30, 160, 255);
         QPen ringPen(ringColor, 2.5, Qt::DashLine);
-        painter->setPen(ringPen);
-        painter->setBrush(Qt::NoBrush);
-        painter->drawRoundedRect(QRectF(-half - 4, -half - 4, SIZE + 8, SIZE + 8), 6, 6);
+        p.setPen(ringPen);
+        p.setBrush(Qt::NoBrush);
+        p.drawRoundedRect(QRectF(-half - 4, -half - 4, SIZE + 8, SIZE + 8), 6, 6);
     }
 
-    switch (m_device->deviceType()) {
-        case Device::Type::Router: drawRouterIcon(painter); break;
-        case Device::Type::Switch: drawSwitchIcon(painter); break;
-        case Device::Type::Hub:    drawHubIcon(painter);    break;
-        case Device::Type::PC:     drawPCIcon(painter);     break;
+    switch (type) {
+        case Device::Type::Router: drawRouterIcon(&p); break;
+        case Device::Type::Switch: drawSwitchIcon(&p); break;
+        case Device::Type::Hub:    drawHubIcon(&p);    break;
+        case Device::Type::PC:     drawPCIcon(&p);     break;
     }
+    p.end();
 
-    // Device name label below icon
-    painter->setPen(Qt::black);
-    QFont nameFont("Arial", 8);
-    painter->setFont(nameFont);
-    painter->drawText(QRectF(-40, half + 3, 80, 18), Qt::AlignCenter, m_device->name());
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
+
+// ---------------------------------------------------------------------------
+// Low-detail glyph: one flat shape per device, no gradients or label
+// ---------------------------------------------------------------------------
+QColor DeviceItem::typeColor(Device::Type type)
+{
+    switch (type) {
+        case Device::Type::Router: return QColor(22, 80, 195);
+        case Device::Type::Switch: return QColor(18, 130, 70);
+        case Device::Type::Hub:    return QColor(205, 110, 15);
+        case Device::Type::PC:     return QColor(88, 88, 108);
+    }
+    return Qt::gray;
+}
+
+void DeviceItem::drawGlyph(QPainter *p) const
+{
+    const qreal R = 22.0;
+    const bool  marked = isSelected() || m_highlighted;
+
+    p->setRenderHint(QPainter::Antialiasing, false);
+    p->setPen(marked ? QPen(m_highlighted ? QColor(255, 215, 0) : QColor(30, 160, 255), 0)
+                     : QPen(Qt::NoPen));
+    p->setBrush(typeColor(m_device->deviceType()));
+    if (m_device->deviceType() == Device::Type::Router)
+        p->drawEllipse(QRectF(-R, -R, R * 2, R * 2));
+    else
+        p->drawRect(QRectF(-R, -R * 0.6, R * 2, R * 1.2));
 }
 
 // ---------------------------------------------------------------------------
@@ -245,7 +347,7 @@ QVariant DeviceItem::itemChange(GraphicsItemChange change, const QVariant &value
         const QPointF pos = value.toPointF();
         m_device->setPosition(pos.x(), pos.y());
         for (LinkItem *link : m_links)
-            link->updatePosition();
+            link->markDirty(); // coalesced once per event-loop tick
     }
     return QGraphicsObject::itemChange(change, value);
 }
@@ -278,8 +380,7 @@ void DeviceItem::openConfigDialog()
             break;
         }
     }
-    update();
-    setToolTip(m_device->name());
+    emit configured();
 }
 
 void DeviceItem::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
@@ -1,6 +1,10 @@
 #pragma once
 #include <QGraphicsObject>
 #include <QRectF>
+#include <QColor>
+#include <QFont>
+#include <QPixmap>
+#include <QStaticText>
 #include "models/Device.h"
 
 class LinkItem;
@@ -11,9 +15,18 @@ class DeviceItem : public QGraphicsObject
 public:
     static constexpr qreal SIZE = 54.0;
 
+    // Level-of-detail thresholds, as view scale.  Below LOD_DETAIL devices
+    // are flat glyphs without labels; below LOD_CLUSTER items draw nothing
+    // and NetworkCanvas paints aggregated cluster glyphs instead.
+    static constexpr qreal LOD_DETAIL  = 0.5;
+    static constexpr qreal LOD_CLUSTER = 0.15;
+
+    static QColor typeColor(Device::Type type); // flat colour for glyphs/clusters
+
     explicit DeviceItem(Device *device, QGraphicsItem *parent = nullptr);
 
     Device *device() const { return m_device; }
+    void    setDevice(Device *device); // rebind after the model object changed or was reloaded
 
     void addLink(LinkItem *link);
     void removeLink(LinkItem *link);
@@ -29,6 +42,7 @@ public:
 
 signals:
     void deleteRequested();
+    void configured(); // a config dialog was closed; the device may have changed
 
 protected:
     QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
@@ -36,7 +50,15 @@ protected:
     void     contextMenuEvent(QGraphicsSceneContextMenuEvent *event) override;
 
 private:
+    enum class Ring { None, Selected, Highlighted };
+    static constexpr qreal ICON_MARGIN = 6.0; // room around the icon for the ring
+
+    static QPixmap      cachedIcon(Device::Type type, Ring ring, qreal scale);
+    static const QFont &nameFont();
+
+    void layoutName();
     void openConfigDialog();
+    void drawGlyph(QPainter *p) const;
     static void drawRouterIcon(QPainter *p);
     static void drawSwitchIcon(QPainter *p);
     static void drawHubIcon(QPainter *p);
@@ -45,4 +67,5 @@ private:
     Device          *m_device;
     QList<LinkItem *> m_links;
     bool             m_highlighted = false;
+    QStaticText      m_nameText; // laid-out name label
 };
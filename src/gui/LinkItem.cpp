@@ -3,7 +3,7 @@
 #include <QPainter>
 #include <QPen>
 #include <QLineF>
-#include <QFontMetrics>
+#include <QFontMetricsF>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QGraphicsSceneMouseEvent>
@@ -12,6 +12,8 @@
 #include <QFormLayout>
 #include <QLabel>
 #include <QDialogButtonBox>
+#include <QTimer>
+#include <utility>
 #include <cmath>
 
 LinkItem::LinkItem(const Link &link, DeviceItem *source, DeviceItem *dest, QGraphicsItem *parent)
@@ -24,9 +26,64 @@ LinkItem::LinkItem(const Link &link, DeviceItem *source, DeviceItem *dest, QGrap
     setFlag(ItemIsSelectable);
     source->addLink(this);
     dest->addLink(this);
+    layoutLabels();
     updatePosition();
 }
 
+LinkItem::~LinkItem()
+{
+    if (m_dirty) s_dirty.removeOne(this);
+}
+
+QList<LinkItem *> LinkItem::s_dirty;
+
+void LinkItem::markDirty()
+{
+    if (m_dirty) return;
+    m_dirty = true;
+    if (s_dirty.isEmpty())
+        QTimer::singleShot(0, &LinkItem::flushDirty);
+    s_dirty.append(this);
+}
+
+void LinkItem::flushDirty()
+{
+    const QList<LinkItem *> pending = std::exchange(s_dirty, {});
+    for (LinkItem *link : pending) {
+        link->m_dirty = false;
+        link->updatePosition();
+    }
+}
+
+void LinkItem::setLink(const Link &link)
+{
+    prepareGeometryChange();
+    const bool relabel = link.interface1 != m_link.interface1 || link.interface2 != m_link.interface2;
+    m_link = link;
+    if (relabel) layoutLabels();
+    update();
+}
+
+static const QFont &labelFont()
+{
+    static const QFont font("Arial", 7);
+    return font;
+}
+
+// Measures and lays out the interface labels once; redone only when an
+// interface name changes.
+void LinkItem::layoutLabels()
+{
+    const QFontMetricsF fm(labelFont());
+    m_labelAscent = fm.ascent();
+    m_labelRect1  = fm.boundingRect(m_link.interface1);
+    m_labelRect2  = fm.boundingRect(m_link.interface2);
+    m_label1.setText(m_link.interface1);
+    m_label2.setText(m_link.interface2);
+    m_label1.prepare(QTransform(), labelFont());
+    m_label2.prepare(QTransform(), labelFont());
+}
+
 void LinkItem::updatePosition()
 {
     prepareGeometryChange();
@@ -39,9 +96,8 @@ QRectF LinkItem::boundingRect() const
     // Start with the line itself plus pen-width margin
     QRectF rect = QRectF(m_line.p1(), m_line.p2()).normalized().adjusted(-2, -2, 2, 2);
 
-    // Grow to include the interface label text rectangles.
-    // Labels are drawn at: endpoint ± unit*22 + perp*8
-    // Use QFontMetrics so we account for any label length and line angle.
+    // Grow to include the interface label text rectangles (baseline-relative,
+    // measured in layoutLabels) at: endpoint ± unit*35 + perp*10
     const qreal len = m_line.length();
     if (len > 85.0) {
         const QPointF dir  = m_line.p2() - m_line.p1();
@@ -51,9 +107,8 @@ QRectF LinkItem::boundingRect() const
         const QPointF lbl1 = m_line.p1() + unit * 35.0 + perp;
         const QPointF lbl2 = m_line.p2() - unit * 35.0 + perp;
 
-        const QFontMetrics fm(QFont("Arial", 7));
-        rect = rect.united(QRectF(fm.boundingRect(m_link.interface1)).translated(lbl1));
-        rect = rect.united(QRectF(fm.boundingRect(m_link.interface2)).translated(lbl2));
+        rect = rect.united(m_labelRect1.translated(lbl1));
+        rect = rect.united(m_labelRect2.translated(lbl2));
     }
 
     // Small extra margin for antialiasing / sub-pixel rendering
@@ -77,11 +132,21 @@ QPainterPath LinkItem::shape() const
 }
 
 void LinkItem::paint(QPainter *painter,
-                     const QStyleOptionGraphicsItem * /*option*/,
+                     const QStyleOptionGraphicsItem *option,
                      QWidget * /*widget*/)
 {
     if (m_line.length() < 1.0) return;
 
+    // Far out the canvas draws clusters; below detail level a hairline
+    // without interface labels is enough
+    const qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+    if (lod < DeviceItem::LOD_CLUSTER) return;
+    if (lod < DeviceItem::LOD_DETAIL) {
+        painter->setPen(QPen(isSelected() ? QColor(0, 160, 255) : QColor(50, 50, 50), 0));
+        painter->drawLine(m_line);
+        return;
+    }
+
     painter->setRenderHint(QPainter::Antialiasing);
 
     QPen pen(isSelected() ? QColor(0, 160, 255) : QColor(50, 50, 50), 2);
@@ -90,8 +155,7 @@ void LinkItem::paint(QPainter *painter,
 
     // Interface labels near each endpoint
     painter->setPen(QColor(80, 80, 80));
-    QFont f("Arial", 7);
-    painter->setFont(f);
+    painter->setFont(labelFont());
 
     // Place labels just outside the device icon edge (icon half-size ~27px,
     // so offset 35px clears all device shapes).  Skip on very short links
@@ -104,8 +168,10 @@ void LinkItem::paint(QPainter *painter,
 
         const QPointF lbl1 = m_line.p1() + unit * 35.0 + perp;
         const QPointF lbl2 = m_line.p2() - unit * 35.0 + perp;
-        painter->drawText(lbl1, m_link.interface1);
-        painter->drawText(lbl2, m_link.interface2);
+        // Static text is positioned by its top-left; lbl1/lbl2 are baselines
+        const QPointF toTop(0, -m_labelAscent);
+        painter->drawStaticText(lbl1 + toTop, m_label1);
+        painter->drawStaticText(lbl2 + toTop, m_label2);
     }
 }
 
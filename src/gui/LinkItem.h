@@ -1,5 +1,6 @@
 #pragma once
 #include <QGraphicsObject>
+#include <QStaticText>
 #include "models/Link.h"
 
 class DeviceItem;
@@ -12,12 +13,17 @@ public:
              DeviceItem *source,
              DeviceItem *dest,
              QGraphicsItem *parent = nullptr);
+    ~LinkItem() override;
 
     const Link &link() const { return m_link; }
+    void        setLink(const Link &link); // same endpoints, refreshed properties
     DeviceItem *sourceItem() const { return m_source; }
     DeviceItem *destItem()   const { return m_dest; }
 
     void updatePosition();
+    // Defers updatePosition() to the next event-loop tick; many endpoint
+    // moves in one tick (e.g. dragging a large selection) cost one update.
+    void markDirty();
 
     QRectF boundingRect() const override;
     void   paint(QPainter *painter,
@@ -29,8 +35,20 @@ protected:
     QPainterPath shape() const override;
 
 private:
+    void layoutLabels();
+    static void flushDirty();
+    static QList<LinkItem *> s_dirty; // GUI thread only
+
     Link        m_link;
     DeviceItem *m_source;
     DeviceItem *m_dest;
     QLineF      m_line;
+    bool        m_dirty = false;
+
+    // Interface labels, laid out once per interface name
+    QStaticText m_label1;
+    QStaticText m_label2;
+    QRectF      m_labelRect1;  // relative to the baseline origin
+    QRectF      m_labelRect2;
+    qreal       m_labelAscent = 0;
 };
@@ -1,8 +1,15 @@
 #include "gui/MainWindow.h"
 #include "gui/NetworkCanvas.h"
+#include "gui/RoutingTableModel.h"
+#include "gui/MulticastTreeModel.h"
 #include "models/Network.h"
+#include "models/DeviceStore.h"
 #include "routing/RoutingEngine.h"
+#include "routing/RouteDiff.h"
 #include "validation/Validator.h"
+#include "validation/DataPlaneVerifier.h"
+#include "layout/ForceLayout.h"
+#include "utils/IpUtils.h"
 #include <QUuid>
 #include <QMenuBar>
 #include <QToolBar>
@@ -11,12 +18,21 @@
 #include <QActionGroup>
 #include <QDockWidget>
 #include <QTextEdit>
+#include <QTabWidget>
+#include <QTableView>
+#include <QHeaderView>
+#include <QComboBox>
+#include <QVBoxLayout>
+#include <QSignalBlocker>
 #include <QLabel>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QCloseEvent>
 #include <QApplication>
+#include <QTimer>
+#include <QtConcurrentRun>
+#include <QElapsedTimer>
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
 {
@@ -30,6 +46,30 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     setCentralWidget(m_canvas);
     connect(m_canvas, &NetworkCanvas::statusMessage, this, &MainWindow::onStatusMessage);
 
+    m_layoutTimer = new QTimer(this);
+    connect(m_layoutTimer, &QTimer::timeout, this, &MainWindow::stepLayout);
+    connect(m_network, &Network::reset, this, &MainWindow::stopLayout);
+    connect(m_network, &Network::reset, this, [this]() {
+        m_hasSimulation = false;
+        ++m_simulationGeneration; // a re-run still in flight is discarded
+    });
+
+    // Once a simulation has run, edits re-run it on a snapshot in the
+    // background (debounced, so a burst of edits costs one run).  Only the
+    // Changes tab is updated; the routing table view keeps the last explicit
+    // run, with its filter and scroll position.
+    m_rerunTimer = new QTimer(this);
+    m_rerunTimer->setSingleShot(true);
+    m_rerunTimer->setInterval(500);
+    connect(m_rerunTimer, &QTimer::timeout, this, &MainWindow::rerunSimulation);
+    connect(m_network, &Network::modified, this, [this]() {
+        if (m_hasSimulation) m_rerunTimer->start();
+    });
+    connect(m_network, &Network::reset, m_rerunTimer, &QTimer::stop);
+    m_rerunWatcher = new QFutureWatcher<SimulationResult>(this);
+    connect(m_rerunWatcher, &QFutureWatcher<SimulationResult>::finished,
+            this, &MainWindow::rerunFinished);
+
     setupMenuBar();
     setupToolBar();
     setupDockWidgets();
@@ -61,11 +101,19 @@ void MainWindow::setupMenuBar()
     // Simulate
     QMenu *simMenu = menuBar()->addMenu("&Simulate");
     simMenu->addAction("&Run Simulation",         this, &MainWindow::runSimulation);
-    simMenu->addAction("Run with &PIM-DM Tree...",this, &MainWindow::runSimulationWithPim);
+    simMenu->addAction("Run with &PIM-DM Trees...",this, &MainWindow::runSimulationWithPim);
 
     // Validate
     QMenu *valMenu = menuBar()->addMenu("&Validate");
     valMenu->addAction("&Validate Network", QKeySequence(Qt::Key_F5), this, &MainWindow::validateNetwork);
+    valMenu->addAction("Verify &Forwarding", QKeySequence(Qt::Key_F7), this, &MainWindow::verifyForwarding);
+    valMenu->addAction("PC &Reachability Matrix", QKeySequence(Qt::Key_F8), this, &MainWindow::checkReachability);
+    valMenu->addAction("&Export Reachability Matrix...", this, &MainWindow::exportReachability);
+
+    // Layout
+    QMenu *layoutMenu = menuBar()->addMenu("&Layout");
+    layoutMenu->addAction("&Auto Layout...", QKeySequence(Qt::CTRL | Qt::Key_L), this, &MainWindow::autoLayout);
+    layoutMenu->addAction("&Fit to Window", this, [this]() { m_canvas->fitToNetwork(); });
 
     // Help
     QMenu *helpMenu = menuBar()->addMenu("&Help");
@@ -131,18 +179,205 @@ void MainWindow::setupDockWidgets()
 {
     m_resultsDock = new QDockWidget("Simulation / Validation Results", this);
     m_resultsDock->setAllowedAreas(Qt::BottomDockWidgetArea | Qt::RightDockWidgetArea);
+    m_resultsTabs = new QTabWidget;
+
+    // Fixed-height rows keep the table views virtual: only visible rows are
+    // measured and painted, and the models hand rows over in batches.
+    auto makeTable = [](QAbstractItemModel *model) {
+        auto *view = new QTableView;
+        view->setModel(model);
+        view->setFont(QFont("Courier New", 9));
+        view->setSelectionBehavior(QAbstractItemView::SelectRows);
+        view->setAlternatingRowColors(true);
+        view->setWordWrap(false);
+        view->verticalHeader()->hide();
+        view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        view->verticalHeader()->setDefaultSectionSize(view->fontMetrics().height() + 4);
+        view->horizontalHeader()->setStretchLastSection(true);
+        return view;
+    };
+
+    // Routing tables, filterable by router
+    m_routesModel = new RoutingTableModel(this);
+    m_routesView  = makeTable(m_routesModel);
+    m_routerFilter = new QComboBox;
+    m_routerFilter->addItem("All routers");
+    connect(m_routerFilter, &QComboBox::currentIndexChanged, this, [this](int index) {
+        m_routesModel->setRouterFilter(index - 1);
+    });
+    auto *routesPage   = new QWidget;
+    auto *routesLayout = new QVBoxLayout(routesPage);
+    routesLayout->setContentsMargins(0, 0, 0, 0);
+    routesLayout->addWidget(m_routerFilter);
+    routesLayout->addWidget(m_routesView);
+    m_resultsTabs->addTab(routesPage, "Routing Tables");
+
+    m_treesModel = new MulticastTreeModel(this);
+    m_treesView  = makeTable(m_treesModel);
+    m_resultsTabs->addTab(m_treesView, "Multicast Trees");
+
+    m_changesView = new QTextEdit;
+    m_changesView->setReadOnly(true);
+    m_changesView->setFont(QFont("Courier New", 9));
+    m_changesView->setPlaceholderText("Route changes since the previous simulation run appear here.");
+    m_resultsTabs->addTab(m_changesView, "Changes");
+
+    m_statsView = new QTextEdit;
+    m_statsView->setReadOnly(true);
+    m_statsView->setFont(QFont("Courier New", 9));
+    m_statsView->setPlaceholderText("Per-phase timings and router warnings of the last simulation run.");
+    m_resultsTabs->addTab(m_statsView, "Statistics");
 
     m_resultsView = new QTextEdit;
     m_resultsView->setReadOnly(true);
     m_resultsView->setFont(QFont("Courier New", 9));
     m_resultsView->setPlaceholderText(
-        "Routing tables and validation results will appear here.\n"
-        "Use Simulate (F6) or Validate (F5).");
-    m_resultsDock->setWidget(m_resultsView);
+        "Validation results will appear here.\n"
+        "Use Validate (F5), Verify Forwarding (F7) or PC Reachability (F8).");
+    m_resultsTabs->addTab(m_resultsView, "Report");
+
+    m_resultsDock->setWidget(m_resultsTabs);
     addDockWidget(Qt::BottomDockWidgetArea, m_resultsDock);
     m_resultsDock->hide();
 }
 
+void MainWindow::showSimulationResult(const SimulationResult &result)
+{
+    m_routesModel->setResult(result);
+    m_treesModel->setTrees(result.multicastTrees);
+
+    {
+        const QSignalBlocker block(m_routerFilter);
+        m_routerFilter->clear();
+        m_routerFilter->addItem("All routers");
+        for (const RouterSimResult &rr : result.routerResults)
+            m_routerFilter->addItem(QString("%1  [%2]").arg(rr.routerName, rr.protocol));
+    }
+
+    m_resultsTabs->setCurrentWidget(result.multicastTrees.isEmpty()
+                                        ? m_routesView->parentWidget()
+                                        : static_cast<QWidget *>(m_treesView));
+    showSimulationStats(result);
+    showRouteChanges(result);
+    m_resultsDock->show();
+}
+
+void MainWindow::showSimulationStats(const SimulationResult &result)
+{
+    const SimulationStats &stats = result.stats;
+    const double totalMs = stats.totalNsecs() / 1e6;
+
+    QString html;
+    html += "<html><body style='font-family:Courier New;font-size:9pt'>";
+    html += "<h3>Simulation Statistics</h3><table cellspacing='0' cellpadding='2'>";
+    for (const PhaseTiming &p : stats.phases) {
+        const double ms = p.nsecs / 1e6;
+        html += QString("<tr><td>%1</td><td align='right'>%2 ms</td><td align='right'>%3%</td></tr>")
+                    .arg(p.name.toHtmlEscaped())
+                    .arg(ms, 0, 'f', 3)
+                    .arg(totalMs > 0 ? 100.0 * ms / totalMs : 0.0, 0, 'f', 1);
+    }
+    html += QString("<tr><td><b>Total</b></td><td align='right'><b>%1 ms</b></td><td></td></tr>")
+                .arg(totalMs, 0, 'f', 3);
+    html += "</table>";
+    html += QString("<p>RIP iterations: %1<br>SPF runs: %2<br>Heap operations: %3<br>"
+                    "Routes installed: %4<br>Peak memory: %5</p>")
+                .arg(stats.ripIterations).arg(stats.spfRuns).arg(stats.heapOps)
+                .arg(stats.routesInstalled)
+                .arg(stats.peakRssKb < 0 ? QString("n/a")
+                                         : QString("%1 MiB").arg(stats.peakRssKb / 1024.0, 0, 'f', 1));
+
+    int warningCount = 0;
+    QString warnings;
+    for (const RouterSimResult &rr : result.routerResults) {
+        if (rr.warnings.isEmpty()) continue;
+        warnings += QString("<b>%1</b><br>").arg(rr.routerName.toHtmlEscaped());
+        for (const QString &w : rr.warnings)
+            warnings += QString("&nbsp;&nbsp;<span style='color:#a60'>[WARN]</span> %1<br>")
+                            .arg(w.toHtmlEscaped());
+        warningCount += rr.warnings.size();
+    }
+    html += QString("<h3>Warnings (%1)</h3>").arg(warningCount);
+    html += warningCount ? warnings : QString("<p style='color:green'>None.</p>");
+    html += "</body></html>";
+    m_statsView->setHtml(html);
+}
+
+// Lists only what changed since the previous run; the Changes tab is brought
+// forward when there is something to review, unless 'bringForward' is false.
+void MainWindow::showRouteChanges(const SimulationResult &result, bool bringForward)
+{
+    if (!m_hasSimulation) {
+        m_changesView->clear();
+        m_lastSimulation = result;
+        m_hasSimulation  = true;
+        return;
+    }
+
+    const RouteDiffResult diff = RouteDiff::compute(m_lastSimulation, result);
+    m_lastSimulation = result;
+
+    QString html;
+    html += "<html><body style='font-family:Courier New;font-size:9pt'>";
+    html += "<h3>Route Changes Since Last Run</h3>";
+    html += "<p><i>Updated in the background after each edit; the routing table view "
+            "shows the last explicit run.</i></p>";
+    if (diff.isEmpty()) {
+        html += "<p style='color:green'><b>No routing table changes.</b></p>";
+    } else {
+        html += QString("<p>%1 router(s) changed: <b>%2 added</b>, <b>%3 removed</b>, "
+                        "<b>%4 next-hop change(s)</b>, <b>%5 metric change(s)</b>.</p>")
+                    .arg(diff.routersChanged).arg(diff.added).arg(diff.removed)
+                    .arg(diff.nextHopChanged).arg(diff.metricChanged);
+
+        const int maxListed = 500;
+        QString router;
+        for (int i = 0; i < diff.changes.size() && i < maxListed; ++i) {
+            const RouteChange &c = diff.changes[i];
+            if (c.routerId != router) {
+                router = c.routerId;
+                html += QString("<b>%1</b><br>").arg(c.routerName.toHtmlEscaped());
+            }
+            const RoutingEntry &e = c.kind == RouteChange::Kind::Removed ? c.before : c.after;
+            QString detail;
+            switch (c.kind) {
+                case RouteChange::Kind::Added:
+                case RouteChange::Kind::Removed:
+                    detail = QString("via %1 (%2), metric %3")
+                                 .arg(e.nextHop, e.exitInterface).arg(e.metric);
+                    break;
+                case RouteChange::Kind::NextHopChanged:
+                    detail = QString("%1 (%2) &rarr; %3 (%4)")
+                                 .arg(c.before.nextHop, c.before.exitInterface,
+                                      c.after.nextHop, c.after.exitInterface);
+                    break;
+                case RouteChange::Kind::MetricChanged:
+                    detail = QString("%1 %2 &rarr; %3 %4")
+                                 .arg(c.before.protocol).arg(c.before.metric)
+                                 .arg(c.after.protocol).arg(c.after.metric);
+                    break;
+            }
+            const QString color = c.kind == RouteChange::Kind::Added   ? "green"
+                                : c.kind == RouteChange::Kind::Removed ? "#c00" : "#a60";
+            html += QString("&nbsp;&nbsp;<span style='color:%1'>[%2]</span> %3/%4 %5<br>")
+                        .arg(color, c.kindString(), e.destination, e.mask, detail);
+        }
+        if (diff.changes.size() > maxListed)
+            html += QString("<p><i>... %1 more change(s) not shown.</i></p>")
+                        .arg(diff.changes.size() - maxListed);
+        if (bringForward) m_resultsTabs->setCurrentWidget(m_changesView);
+    }
+    html += "</body></html>";
+    m_changesView->setHtml(html);
+}
+
+void MainWindow::showReport(const QString &html)
+{
+    m_resultsView->setHtml(html);
+    m_resultsTabs->setCurrentWidget(m_resultsView);
+    m_resultsDock->show();
+}
+
 // ---------------------------------------------------------------------------
 void MainWindow::updateTitle()
 {
@@ -182,7 +417,6 @@ bool MainWindow::confirmDiscardChanges()
 void MainWindow::newNetwork()
 {
     if (!confirmDiscardChanges()) return;
-    m_canvas->clear();
     m_network->clear();
     m_currentFile.clear();
     m_modified = false;
@@ -202,7 +436,6 @@ void MainWindow::openNetwork()
         QMessageBox::critical(this, "Open Failed", error);
         return;
     }
-    m_canvas->rebuildFromNetwork();
     m_currentFile = path;
     m_modified    = false;
     updateTitle();
@@ -236,80 +469,75 @@ bool MainWindow::saveNetworkAs()
 // ---------------------------------------------------------------------------
 void MainWindow::runSimulation()
 {
+    m_lastFlows.clear();
+    ++m_simulationGeneration;
     const SimulationResult result = RoutingEngine::run(m_network);
+    showSimulationResult(result);
+    onStatusMessage(QString("Simulation complete: %1 route(s) on %2 router(s) in %3 ms.")
+                        .arg(m_routesModel->totalRoutes()).arg(result.routerResults.size())
+                        .arg(result.stats.totalNsecs() / 1e6, 0, 'f', 1));
+}
 
-    QString html;
-    html += "<html><body style='font-family:Courier New;font-size:9pt'>";
-    html += "<h3>Routing Simulation Results</h3>";
-
-    for (const RouterSimResult &rr : result.routerResults) {
-        html += QString("<b>%1</b>  [%2]<br>").arg(rr.routerName.toHtmlEscaped(),
-                                                    rr.protocol.toHtmlEscaped());
-        html += "<table border='1' cellspacing='0' cellpadding='3' style='border-collapse:collapse'>";
-        html += "<tr style='background:#dde'>"
-                "<th>Destination</th><th>Mask</th><th>Next Hop</th>"
-                "<th>Interface</th><th>Metric</th><th>Protocol</th></tr>";
-
-        if (rr.routingTable.isEmpty()) {
-            html += "<tr><td colspan='6'><i>No routes</i></td></tr>";
-        } else {
-            for (const RoutingEntry &e : rr.routingTable) {
-                html += QString("<tr><td>%1</td><td>%2</td><td>%3</td>"
-                                "<td>%4</td><td>%5</td><td>%6</td></tr>")
-                            .arg(e.destination, e.mask, e.nextHop,
-                                 e.exitInterface, QString::number(e.metric), e.protocol);
-            }
+void MainWindow::runSimulationWithPim()
+{
+    bool ok;
+    const QString text = QInputDialog::getMultiLineText(
+        this, "PIM-DM Flows",
+        "One multicast flow per line: <source IP> <group address>\n"
+        "(e.g. 192.168.1.10 239.1.1.1)",
+        {}, &ok);
+    if (!ok || text.trimmed().isEmpty()) return;
+
+    QList<MulticastFlow> flows;
+    for (const QString &line : text.split('\n', Qt::SkipEmptyParts)) {
+        const QStringList parts = line.simplified().split(' ');
+        if (parts.size() != 2 || !IpUtils::isValidIp(parts[0]) || !IpUtils::isValidIp(parts[1])) {
+            QMessageBox::warning(this, "Invalid Flow", "Expected '<source IP> <group address>': " + line);
+            return;
         }
-        html += "</table><br>";
+        flows.append({parts[0], parts[1]});
     }
 
-    html += "</body></html>";
-    m_resultsView->setHtml(html);
-    m_resultsDock->show();
-    onStatusMessage("Simulation complete.");
+    m_lastFlows = flows;
+    ++m_simulationGeneration;
+    const SimulationResult result = RoutingEngine::run(m_network, flows);
+    showSimulationResult(result);
+    onStatusMessage(QString("Simulation complete: %1 multicast tree(s) in %2 ms.")
+                        .arg(result.multicastTrees.size())
+                        .arg(result.stats.totalNsecs() / 1e6, 0, 'f', 1));
 }
 
-void MainWindow::runSimulationWithPim()
+// After an edit: the same run as last time, on a copy of the network in a
+// worker thread, so the GUI keeps responding on large networks
+void MainWindow::rerunSimulation()
 {
-    bool ok;
-    const QString src = QInputDialog::getText(
-        this, "PIM-DM Source", "Multicast source IP address:", QLineEdit::Normal, {}, &ok);
-    if (!ok || src.isEmpty()) return;
-
-    const QString grp = QInputDialog::getText(
-        this, "PIM-DM Group", "Multicast group address (e.g. 239.1.1.1):",
-        QLineEdit::Normal, "239.1.1.1", &ok);
-    if (!ok || grp.isEmpty()) return;
-
-    SimulationResult result = RoutingEngine::run(m_network, src, grp);
-
-    // Show unicast tables first
-    runSimulation(); // re-populates view
-
-    QString html = m_resultsView->toHtml();
-    html.replace("</body>", ""); // we'll append
-
-    html += "<h3>PIM Dense Mode — Multicast Distribution Tree</h3>";
-    for (const MulticastTree &tree : result.multicastTrees) {
-        html += QString("<b>Source:</b> %1 &nbsp; <b>Group:</b> %2<br>")
-                    .arg(tree.sourceIp, tree.groupAddress);
-        html += "<table border='1' cellspacing='0' cellpadding='3' style='border-collapse:collapse'>";
-        html += "<tr style='background:#ded'>"
-                "<th>Router</th><th>RPF (Incoming)</th><th>OIL (Outgoing)</th></tr>";
-        for (const MulticastTreeEntry &e : tree.entries) {
-            html += QString("<tr><td>%1</td><td>%2</td><td>%3</td></tr>")
-                        .arg(e.routerName,
-                             e.incomingInterface.isEmpty() ? "<i>source</i>" : e.incomingInterface,
-                             e.outgoingInterfaces.join(", "));
-        }
-        html += "</table>";
-        if (!tree.pruned.isEmpty())
-            html += QString("<br><b>Pruned:</b> %1<br>").arg(tree.pruned.join(", "));
-        html += "<br>";
+    if (!m_hasSimulation) return;
+    if (m_rerunWatcher->isRunning()) {
+        m_rerunPending = true; // picked up when the running one finishes
+        return;
     }
-    html += "</body></html>";
-    m_resultsView->setHtml(html);
-    m_resultsDock->show();
+    m_rerunPending    = false;
+    m_rerunGeneration = m_simulationGeneration;
+    const DeviceStore snapshot = DeviceStore::fromNetwork(m_network);
+    const QList<MulticastFlow> flows = m_lastFlows;
+    m_rerunWatcher->setFuture(QtConcurrent::run([snapshot, flows]() {
+        Network copy;
+        snapshot.toNetwork(&copy);
+        return RoutingEngine::run(&copy, flows);
+    }));
+    onStatusMessage("Re-simulating after edit...");
+}
+
+void MainWindow::rerunFinished()
+{
+    // Results of a run overtaken by an explicit run or a reset are dropped
+    if (m_hasSimulation && m_rerunGeneration == m_simulationGeneration) {
+        const SimulationResult result = m_rerunWatcher->result();
+        showRouteChanges(result, false);
+        onStatusMessage(QString("Re-simulated after edit in %1 ms; see the Changes tab.")
+                            .arg(result.stats.totalNsecs() / 1e6, 0, 'f', 1));
+    }
+    if (m_rerunPending) m_rerunTimer->start();
 }
 
 // ---------------------------------------------------------------------------
@@ -347,12 +575,98 @@ void MainWindow::validateNetwork()
         }
     }
     html += "</body></html>";
-    m_resultsView->setHtml(html);
-    m_resultsDock->show();
+    showReport(html);
     onStatusMessage(issues.isEmpty() ? "Validation passed." :
                     QString("Validation: %1 issue(s) found.").arg(issues.size()));
 }
 
+void MainWindow::verifyForwarding()
+{
+    RoutingEngine::run(m_network); // refresh the computed tables being verified
+    const DataPlaneReport report = DataPlaneVerifier::verify(m_network);
+
+    QString html;
+    html += "<html><body style='font-family:Courier New;font-size:9pt'>";
+    html += "<h3>Forwarding Verification</h3>";
+    html += QString("<p>Checked %1 (router, destination) pair(s) across %2 equivalence class(es).</p>")
+                .arg(report.pairsChecked).arg(report.equivalenceClasses);
+
+    if (report.issues.isEmpty()) {
+        html += "<p style='color:green'><b>✔ Every computed route delivers its packets.</b></p>";
+    } else {
+        for (const ForwardingIssue &issue : report.issues) {
+            html += QString("<p style='color:#c00'><b>[%1]</b> %2")
+                        .arg(issue.kindString(), issue.message.toHtmlEscaped());
+            if (issue.affectedRouters > 1)
+                html += QString(" <i>(%1 routers affected)</i>").arg(issue.affectedRouters);
+            html += "</p>";
+        }
+    }
+    html += "</body></html>";
+    showReport(html);
+    onStatusMessage(report.issues.isEmpty() ? "Forwarding verification passed." :
+                    QString("Forwarding verification: %1 issue(s) found.").arg(report.issues.size()));
+}
+
+void MainWindow::checkReachability()
+{
+    RoutingEngine::run(m_network);
+    const ReachabilityMatrix matrix = ReachabilityMatrix::compute(m_network);
+    const int n = matrix.size();
+
+    QString html;
+    html += "<html><body style='font-family:Courier New;font-size:9pt'>";
+    html += "<h3>PC Reachability</h3>";
+    html += QString("<p>%1 of %2 PC pair(s) can deliver packets.</p>")
+                .arg(matrix.reachablePairs()).arg(qint64(n) * n);
+
+    const int maxListed = 50;
+    int listed = 0;
+    for (int s = 0; s < n && listed < maxListed; ++s) {
+        if (matrix.reachableCount(s) == n) continue;
+        for (int t = 0; t < n && listed < maxListed; ++t) {
+            if (matrix.reachable(s, t)) continue;
+            html += QString("<p style='color:#c00'>%1 &rarr; %2 unreachable</p>")
+                        .arg(matrix.pcNames()[s].toHtmlEscaped(), matrix.pcNames()[t].toHtmlEscaped());
+            ++listed;
+        }
+    }
+
+    if (m_hasReachability) {
+        const ReachabilityDiff d = ReachabilityMatrix::diff(m_lastReachability, matrix, maxListed);
+        html += QString("<h3>Changes Since Last Check</h3><p>%1 pair(s) gained, %2 pair(s) lost.</p>")
+                    .arg(d.gained).arg(d.lost);
+        for (const QString &name : d.removedPcs)
+            html += QString("<p style='color:#c00'>- PC %1 removed</p>").arg(name.toHtmlEscaped());
+        for (const QString &name : d.addedPcs)
+            html += QString("<p style='color:green'>+ PC %1 added</p>").arg(name.toHtmlEscaped());
+        for (const auto &p : d.lostPairs)
+            html += QString("<p style='color:#c00'>- %1 &rarr; %2</p>")
+                        .arg(p.first.toHtmlEscaped(), p.second.toHtmlEscaped());
+        for (const auto &p : d.gainedPairs)
+            html += QString("<p style='color:green'>+ %1 &rarr; %2</p>")
+                        .arg(p.first.toHtmlEscaped(), p.second.toHtmlEscaped());
+    }
+    html += "</body></html>";
+
+    m_lastReachability = matrix;
+    m_hasReachability  = true;
+    showReport(html);
+    onStatusMessage("Reachability matrix computed.");
+}
+
+void MainWindow::exportReachability()
+{
+    if (!m_hasReachability) checkReachability();
+    const QString path = QFileDialog::getSaveFileName(
+        this, "Export Reachability Matrix", {}, "Reachability Matrix (*.reach);;All Files (*)");
+    if (path.isEmpty()) return;
+
+    QString error;
+    if (!m_lastReachability.save(path, &error))
+        QMessageBox::critical(this, "Export Failed", error);
+}
+
 // ---------------------------------------------------------------------------
 void MainWindow::showAbout()
 {
@@ -371,43 +685,93 @@ void MainWindow::closeEvent(QCloseEvent *event)
         event->ignore();
 }
 
+// ---------------------------------------------------------------------------
+// Auto layout: the layout is stepped from a timer so the canvas can show
+// intermediate positions; each step parallelises its force computation.
+// ---------------------------------------------------------------------------
+void MainWindow::autoLayout()
+{
+    const QStringList modes = {"Force-directed", "Hierarchical (core / distribution / access)"};
+    bool ok = false;
+    const QString choice = QInputDialog::getItem(this, "Auto Layout", "Layout style:",
+                                                 modes, 0, false, &ok);
+    if (!ok) return;
+
+    LayoutOptions options;
+    options.mode = (choice == modes[1]) ? LayoutOptions::Mode::Hierarchical
+                                        : LayoutOptions::Mode::ForceDirected;
+    stopLayout();
+    m_layout = std::make_unique<ForceLayout>(m_network, options);
+    onStatusMessage(QString("Laying out %1 devices...").arg(m_layout->nodeCount()));
+    m_layoutTimer->start(0);
+}
+
+void MainWindow::stepLayout()
+{
+    if (!m_layout) return;
+
+    // Iterate for about one frame, then show where the devices are
+    QElapsedTimer frame;
+    frame.start();
+    bool running = true;
+    while (running && frame.elapsed() < 30)
+        running = m_layout->step();
+
+    m_canvas->applyPositions(m_layout->positions());
+    m_modified = true;
+
+    if (running) {
+        onStatusMessage(QString("Laying out... iteration %1").arg(m_layout->iteration()));
+        return;
+    }
+    onStatusMessage(QString("Layout finished after %1 iterations.").arg(m_layout->iteration()));
+    stopLayout();
+    m_canvas->fitToNetwork();
+    updateTitle();
+}
+
+void MainWindow::stopLayout()
+{
+    m_layoutTimer->stop();
+    m_layout.reset();
+}
+
 // ---------------------------------------------------------------------------
 // Sample Network
 // ---------------------------------------------------------------------------
 void MainWindow::createSampleNetwork()
 {
     if (!confirmDiscardChanges()) return;
-    m_canvas->clear();
     m_network->clear();
 
     // ---- Routers ----------------------------------------------------------
     auto *r1 = new Router("R1");
     r1->setPosition(-350, 0);
     r1->setRoutingProtocol(Router::RoutingProtocol::RIPv2);
-    r1->getInterface("Gi0/0")->ipAddress  = "10.0.0.1";
-    r1->getInterface("Gi0/0")->subnetMask = "255.255.255.252";
-    r1->getInterface("Gi0/1")->ipAddress  = "192.168.1.1";
-    r1->getInterface("Gi0/1")->subnetMask = "255.255.255.0";
+    r1->getInterface("Gi0/0")->setIpAddress("10.0.0.1");
+    r1->getInterface("Gi0/0")->setSubnetMask("255.255.255.252");
+    r1->getInterface("Gi0/1")->setIpAddress("192.168.1.1");
+    r1->getInterface("Gi0/1")->setSubnetMask("255.255.255.0");
     r1->ripv2Config().networks            = {"192.168.1.0", "10.0.0.0"};
 
     auto *r2 = new Router("R2");
     r2->setPosition(0, 0);
     r2->setRoutingProtocol(Router::RoutingProtocol::RIPv2);
-    r2->getInterface("Gi0/0")->ipAddress  = "10.0.0.2";
-    r2->getInterface("Gi0/0")->subnetMask = "255.255.255.252";
-    r2->getInterface("Gi0/1")->ipAddress  = "172.16.0.1";
-    r2->getInterface("Gi0/1")->subnetMask = "255.255.0.0";
-    r2->getInterface("Gi0/2")->ipAddress  = "10.0.1.1";
-    r2->getInterface("Gi0/2")->subnetMask = "255.255.255.252";
+    r2->getInterface("Gi0/0")->setIpAddress("10.0.0.2");
+    r2->getInterface("Gi0/0")->setSubnetMask("255.255.255.252");
+    r2->getInterface("Gi0/1")->setIpAddress("172.16.0.1");
+    r2->getInterface("Gi0/1")->setSubnetMask("255.255.0.0");
+    r2->getInterface("Gi0/2")->setIpAddress("10.0.1.1");
+    r2->getInterface("Gi0/2")->setSubnetMask("255.255.255.252");
     r2->ripv2Config().networks            = {"172.16.0.0", "10.0.0.0", "10.0.1.0"};
 
     auto *r3 = new Router("R3");
     r3->setPosition(350, 0);
     r3->setRoutingProtocol(Router::RoutingProtocol::PIM_DM);
-    r3->getInterface("Gi0/0")->ipAddress  = "10.0.1.2";
-    r3->getInterface("Gi0/0")->subnetMask = "255.255.255.252";
-    r3->getInterface("Gi0/1")->ipAddress  = "192.168.2.1";
-    r3->getInterface("Gi0/1")->subnetMask = "255.255.255.0";
+    r3->getInterface("Gi0/0")->setIpAddress("10.0.1.2");
+    r3->getInterface("Gi0/0")->setSubnetMask("255.255.255.252");
+    r3->getInterface("Gi0/1")->setIpAddress("192.168.2.1");
+    r3->getInterface("Gi0/1")->setSubnetMask("255.255.255.0");
     r3->pimdmConfig().enabledInterfaces   = {"Gi0/0", "Gi0/1"};
 
     // ---- Switches ---------------------------------------------------------
@@ -427,8 +791,8 @@ void MainWindow::createSampleNetwork()
                      qreal x, qreal y) -> PC * {
         auto *pc = new PC(name);
         pc->setPosition(x, y);
-        pc->getInterface("eth0")->ipAddress  = ip;
-        pc->getInterface("eth0")->subnetMask = mask;
+        pc->getInterface("eth0")->setIpAddress(ip);
+        pc->getInterface("eth0")->setSubnetMask(mask);
         pc->setDefaultGateway(gw);
         return pc;
     };
@@ -478,8 +842,7 @@ void MainWindow::createSampleNetwork()
     m_network->addLink(makeLink(hub1->id(), "Port1", pc5->id(),  "eth0"));  // Hub1 -> PC5
     m_network->addLink(makeLink(hub1->id(), "Port2", pc6->id(),  "eth0"));  // Hub1 -> PC6
 
-    // ---- Sync canvas and state --------------------------------------------
-    m_canvas->rebuildFromNetwork();
+    // ---- State (the canvas followed the Network's change signals) ---------
     m_currentFile.clear();
     m_modified = false;
     updateTitle();
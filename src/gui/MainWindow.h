@@ -1,14 +1,25 @@
 #pragma once
 #include <QMainWindow>
 #include <QString>
+#include <QFutureWatcher>
+#include <memory>
+#include "validation/ReachabilityMatrix.h"
+#include "routing/RoutingEngine.h"
 
 class Network;
 class NetworkCanvas;
 class QTextEdit;
+class QTabWidget;
+class QTableView;
+class QComboBox;
+class RoutingTableModel;
+class MulticastTreeModel;
 class QDockWidget;
 class QActionGroup;
 class QAction;
 class QLabel;
+class QTimer;
+class ForceLayout;
 
 class MainWindow : public QMainWindow
 {
@@ -29,6 +40,13 @@ private slots:
     void runSimulation();
     void runSimulationWithPim();
     void validateNetwork();
+    void verifyForwarding();
+    void checkReachability();
+    void exportReachability();
+    void autoLayout();
+    void stepLayout();
+    void rerunSimulation();
+    void rerunFinished();
     void showAbout();
     void onStatusMessage(const QString &msg);
     void setModeSelect();
@@ -45,13 +63,38 @@ private:
     void setupDockWidgets();
     void updateTitle();
     bool confirmDiscardChanges();
+    void stopLayout();
+    void showSimulationResult(const SimulationResult &result);
+    void showReport(const QString &html);
+    void showRouteChanges(const SimulationResult &result, bool bringForward = true);
+    void showSimulationStats(const SimulationResult &result);
 
     Network        *m_network     = nullptr;
     NetworkCanvas  *m_canvas      = nullptr;
-    QTextEdit      *m_resultsView = nullptr;
+    QTextEdit      *m_resultsView = nullptr; // validation / verification reports
     QDockWidget    *m_resultsDock = nullptr;
+    QTabWidget     *m_resultsTabs = nullptr;
+    RoutingTableModel  *m_routesModel  = nullptr;
+    QTableView         *m_routesView   = nullptr;
+    QComboBox          *m_routerFilter = nullptr;
+    MulticastTreeModel *m_treesModel   = nullptr;
+    QTableView         *m_treesView    = nullptr;
+    QTextEdit          *m_changesView  = nullptr;
+    QTextEdit          *m_statsView    = nullptr; // timings, counters and warnings
+    SimulationResult    m_lastSimulation;  // previous run, for route-change diffs
+    bool                m_hasSimulation = false;
+    QList<MulticastFlow> m_lastFlows;      // flows of the last run, reused on edits
+    QTimer             *m_rerunTimer = nullptr; // re-simulates once edits settle
+    QFutureWatcher<SimulationResult> *m_rerunWatcher = nullptr; // background re-run
+    int                 m_simulationGeneration = 0; // bumped by explicit runs and resets
+    int                 m_rerunGeneration = 0;      // generation the running re-run started in
+    bool                m_rerunPending = false;     // edited again while a re-run was running
     QLabel         *m_statusLabel = nullptr;
     QActionGroup   *m_modeGroup   = nullptr;
+    ReachabilityMatrix m_lastReachability; // previous run, for diffing
+    bool            m_hasReachability = false;
+    std::unique_ptr<ForceLayout> m_layout; // auto-layout in progress, if any
+    QTimer         *m_layoutTimer = nullptr;
     QString         m_currentFile;
     bool            m_modified    = false;
 };
@@ -0,0 +1,71 @@
+#include "gui/MulticastTreeModel.h"
+#include <QFont>
+
+MulticastTreeModel::MulticastTreeModel(QObject *parent)
+    : QAbstractTableModel(parent) {}
+
+void MulticastTreeModel::setTrees(const QList<MulticastTree> &trees)
+{
+    beginResetModel();
+    m_trees = trees;
+    m_rows.clear();
+    for (int t = 0; t < m_trees.size(); ++t) {
+        for (int e = 0; e < m_trees[t].entries.size(); ++e) m_rows.append({t, e});
+        for (int p = 0; p < m_trees[t].pruned.size(); ++p)  m_rows.append({t, -1 - p});
+    }
+    endResetModel();
+}
+
+int MulticastTreeModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
+}
+
+int MulticastTreeModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant MulticastTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) return {};
+
+    const Row           &row   = m_rows[index.row()];
+    const MulticastTree &tree  = m_trees[row.tree];
+    const bool           pruned = row.entry < 0;
+
+    if (role == Qt::FontRole && pruned) {
+        QFont f;
+        f.setItalic(true);
+        return f;
+    }
+    if (role != Qt::DisplayRole) return {};
+
+    switch (index.column()) {
+        case SourceCol: return tree.sourceIp;
+        case GroupCol:  return tree.groupAddress;
+        case RouterCol:
+            return pruned ? tree.pruned[-1 - row.entry] : tree.entries[row.entry].routerName;
+        case IncomingCol: {
+            if (pruned) return "(pruned)";
+            const QString &in = tree.entries[row.entry].incomingInterface;
+            return in.isEmpty() ? QString("(source)") : in;
+        }
+        case OutgoingCol:
+            return pruned ? QString() : tree.entries[row.entry].outgoingInterfaces.join(", ");
+    }
+    return {};
+}
+
+QVariant MulticastTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return {};
+    switch (section) {
+        case SourceCol:   return "Source";
+        case GroupCol:    return "Group";
+        case RouterCol:   return "Router";
+        case IncomingCol: return "RPF (Incoming)";
+        case OutgoingCol: return "OIL (Outgoing)";
+    }
+    return {};
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <QAbstractTableModel>
+#include <QList>
+#include "routing/PIMDenseMode.h"
+
+// ---------------------------------------------------------------------------
+// MulticastTreeModel
+//
+// One row per (tree, router): the routers on each PIM-DM tree with their RPF
+// and outgoing interfaces, followed by the routers that were pruned.
+// ---------------------------------------------------------------------------
+class MulticastTreeModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column { SourceCol, GroupCol, RouterCol, IncomingCol, OutgoingCol, ColumnCount };
+
+    explicit MulticastTreeModel(QObject *parent = nullptr);
+
+    void setTrees(const QList<MulticastTree> &trees);
+    void clear() { setTrees({}); }
+
+    int      rowCount(const QModelIndex &parent = {}) const override;
+    int      columnCount(const QModelIndex &parent = {}) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+private:
+    struct Row {
+        int tree;
+        int entry; // index into entries, or -1 - index into pruned
+    };
+
+    QList<MulticastTree> m_trees;
+    QList<Row>           m_rows;
+};
@@ -4,11 +4,14 @@
 #include "models/Network.h"
 #include <QGraphicsScene>
 #include <QMouseEvent>
+#include <QWheelEvent>
+#include <QStyleOptionGraphicsItem>
 #include <QKeyEvent>
 #include <QPainter>
 #include <QUuid>
 #include <QTransform>
 #include <QMessageBox>
+#include <cmath>
 
 NetworkCanvas::NetworkCanvas(Network *network, QWidget *parent)
     : QGraphicsView(parent)
@@ -23,6 +26,14 @@ NetworkCanvas::NetworkCanvas(Network *network, QWidget *parent)
     setTransformationAnchor(AnchorUnderMouse);
     setResizeAnchor(AnchorUnderMouse);
     setBackgroundBrush(QBrush(QColor(245, 245, 250)));
+
+    connect(m_network, &Network::deviceAdded,   this, &NetworkCanvas::onDeviceAdded);
+    connect(m_network, &Network::deviceRemoved, this, &NetworkCanvas::onDeviceRemoved);
+    connect(m_network, &Network::deviceChanged, this, &NetworkCanvas::onDeviceChanged);
+    connect(m_network, &Network::linkAdded,     this, &NetworkCanvas::onLinkAdded);
+    connect(m_network, &Network::linkRemoved,   this, &NetworkCanvas::onLinkRemoved);
+    connect(m_network, &Network::reset,         this, &NetworkCanvas::syncWithNetwork);
+    syncWithNetwork();
 }
 
 // ---------------------------------------------------------------------------
@@ -75,34 +86,132 @@ void NetworkCanvas::setMode(Mode mode)
 }
 
 // ---------------------------------------------------------------------------
-void NetworkCanvas::clear()
+// Model change handling.  Items are keyed by device/link id and only the ones
+// named in a change event are created, updated or destroyed.
+// ---------------------------------------------------------------------------
+DeviceItem *NetworkCanvas::addDeviceItem(Device *device)
 {
-    m_scene->clear();
-    m_deviceItems.clear();
-    m_linkItems.clear();
-    m_connectSource = nullptr;
+    auto *item = new DeviceItem(device);
+    item->setPos(device->x(), device->y());
+    m_scene->addItem(item);
+    m_deviceItems.insert(device->id(), item);
+    connectItemSignals(item);
+    return item;
+}
+
+LinkItem *NetworkCanvas::addLinkItem(const Link &link)
+{
+    DeviceItem *src = m_deviceItems.value(link.device1Id);
+    DeviceItem *dst = m_deviceItems.value(link.device2Id);
+    if (!src || !dst) return nullptr;
+    auto *item = new LinkItem(link, src, dst);
+    m_scene->addItem(item);
+    m_linkItems.insert(link.id, item);
+    return item;
+}
+
+void NetworkCanvas::removeLinkItem(const QString &linkId)
+{
+    LinkItem *item = m_linkItems.take(linkId);
+    if (!item) return;
+    item->sourceItem()->removeLink(item);
+    item->destItem()->removeLink(item);
+    m_scene->removeItem(item);
+    delete item;
 }
 
-void NetworkCanvas::rebuildFromNetwork()
+void NetworkCanvas::removeDeviceItem(const QString &deviceId)
 {
-    clear();
+    DeviceItem *item = m_deviceItems.take(deviceId);
+    if (!item) return;
+    if (item == m_connectSource) m_connectSource = nullptr;
+    m_scene->removeItem(item);
+    delete item;
+}
+
+void NetworkCanvas::onDeviceAdded(const QString &deviceId)
+{
+    if (Device *dev = m_network->device(deviceId))
+        addDeviceItem(dev);
+}
+
+void NetworkCanvas::onDeviceRemoved(const QString &deviceId)
+{
+    removeDeviceItem(deviceId); // its links were already reported removed
+}
+
+void NetworkCanvas::onDeviceChanged(const QString &deviceId)
+{
+    DeviceItem *item = m_deviceItems.value(deviceId);
+    Device     *dev  = m_network->device(deviceId);
+    if (item && dev) item->setDevice(dev);
+}
+
+void NetworkCanvas::onLinkAdded(const QString &linkId)
+{
+    if (const Link *link = m_network->link(linkId))
+        addLinkItem(*link);
+}
+
+void NetworkCanvas::onLinkRemoved(const QString &linkId)
+{
+    removeLinkItem(linkId);
+}
+
+// After a clear() or load(): drop items whose ids are gone, rebind the ones
+// that survive to the new model objects, and create the rest.
+void NetworkCanvas::syncWithNetwork()
+{
+    if (m_connectSource) {
+        m_connectSource->setHighlighted(false);
+        m_connectSource = nullptr;
+    }
+
+    for (const QString &id : m_linkItems.keys()) {
+        const Link *link = m_network->link(id);
+        const Link &shown = m_linkItems.value(id)->link();
+        if (!link || link->device1Id != shown.device1Id || link->device2Id != shown.device2Id)
+            removeLinkItem(id);
+    }
+    for (const QString &id : m_deviceItems.keys())
+        if (!m_network->device(id)) removeDeviceItem(id);
+
     for (Device *dev : m_network->devices()) {
-        auto *item = new DeviceItem(dev);
-        item->setPos(dev->x(), dev->y());
-        m_scene->addItem(item);
-        m_deviceItems.insert(dev->id(), item);
-        connectItemSignals(item);
+        if (DeviceItem *item = m_deviceItems.value(dev->id()))
+            item->setDevice(dev);
+        else
+            addDeviceItem(dev);
     }
     for (const Link *link : m_network->links()) {
-        DeviceItem *src = m_deviceItems.value(link->device1Id);
-        DeviceItem *dst = m_deviceItems.value(link->device2Id);
-        if (!src || !dst) continue;
-        auto *litem = new LinkItem(*link, src, dst);
-        m_scene->addItem(litem);
-        m_linkItems.insert(link->id, litem);
+        if (LinkItem *item = m_linkItems.value(link->id)) {
+            item->setLink(*link);
+            item->updatePosition();
+        } else {
+            addLinkItem(*link);
+        }
     }
 }
 
+// ---------------------------------------------------------------------------
+void NetworkCanvas::applyPositions(const QList<QPair<QString, QPointF>> &positions)
+{
+    QRectF bounds;
+    for (const auto &p : positions) {
+        DeviceItem *item = m_deviceItems.value(p.first);
+        if (!item) continue;
+        item->setPos(p.second); // itemChange writes the device position
+        bounds |= QRectF(p.second, QSizeF(1, 1));
+    }
+    if (!bounds.isNull())
+        m_scene->setSceneRect(m_scene->sceneRect().united(bounds.adjusted(-200, -200, 200, 200)));
+}
+
+void NetworkCanvas::fitToNetwork()
+{
+    if (m_deviceItems.isEmpty()) return;
+    fitInView(m_scene->itemsBoundingRect(), Qt::KeepAspectRatio);
+}
+
 // ---------------------------------------------------------------------------
 void NetworkCanvas::mousePressEvent(QMouseEvent *event)
 {
@@ -144,23 +253,57 @@ void NetworkCanvas::mousePressEvent(QMouseEvent *event)
     }
 }
 
+void NetworkCanvas::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_mode == Mode::Select && !m_indexSuspended && (event->buttons() & Qt::LeftButton) &&
+        qgraphicsitem_cast<DeviceItem *>(m_scene->mouseGrabberItem()) &&
+        m_scene->selectedItems().size() >= DRAG_NOINDEX_THRESHOLD) {
+        m_scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+        m_indexSuspended = true;
+    }
+    QGraphicsView::mouseMoveEvent(event);
+}
+
+void NetworkCanvas::mouseReleaseEvent(QMouseEvent *event)
+{
+    QGraphicsView::mouseReleaseEvent(event);
+    if (m_indexSuspended) {
+        m_scene->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+        m_indexSuspended = false;
+    }
+}
+
 void NetworkCanvas::keyPressEvent(QKeyEvent *event)
 {
     if (event->key() == Qt::Key_Delete || event->key() == Qt::Key_Backspace) {
-        const auto selected = m_scene->selectedItems();
-        for (auto *item : selected) {
-            if (auto *di = qgraphicsitem_cast<DeviceItem *>(item)) {
-                deleteDeviceItem(di);
-            } else if (auto *li = qgraphicsitem_cast<LinkItem *>(item)) {
-                deleteLinkItem(li);
-            }
+        // Collect ids first: removing a device also destroys its link items
+        QStringList deviceIds, linkIds;
+        for (auto *item : m_scene->selectedItems()) {
+            if (auto *di = qgraphicsitem_cast<DeviceItem *>(item))
+                deviceIds.append(di->device()->id());
+            else if (auto *li = qgraphicsitem_cast<LinkItem *>(item))
+                linkIds.append(li->link().id);
         }
+        for (const QString &id : linkIds)
+            if (LinkItem *li = m_linkItems.value(id)) deleteLinkItem(li);
+        for (const QString &id : deviceIds)
+            if (DeviceItem *di = m_deviceItems.value(id)) deleteDeviceItem(di);
     }
     QGraphicsView::keyPressEvent(event);
 }
 
 void NetworkCanvas::dragEnterEvent(QDragEnterEvent * /*event*/) {}
 
+void NetworkCanvas::wheelEvent(QWheelEvent *event)
+{
+    // Zoom around the cursor (transformation anchor is AnchorUnderMouse)
+    const qreal factor  = std::pow(1.15, event->angleDelta().y() / 120.0);
+    const qreal current = transform().m11();
+    const qreal target  = qBound(0.02, current * factor, 4.0);
+    scale(target / current, target / current);
+    event->accept();
+}
+
 // ---------------------------------------------------------------------------
 // Drawing
 // ---------------------------------------------------------------------------
@@ -168,8 +311,10 @@ void NetworkCanvas::drawBackground(QPainter *painter, const QRectF &rect)
 {
     QGraphicsView::drawBackground(painter, rect);
 
-    // Light grid
+    // Light grid, dropped once its lines would be closer than a few pixels
     const int step = 40;
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    if (step * lod < 6.0) return;
     painter->setPen(QPen(QColor(210, 210, 220), 0.5));
 
     const int left  = static_cast<int>(rect.left())  - (static_cast<int>(rect.left())  % step);
@@ -181,6 +326,58 @@ void NetworkCanvas::drawBackground(QPainter *painter, const QRectF &rect)
         painter->drawLine(static_cast<int>(rect.left()), y, static_cast<int>(rect.right()), y);
 }
 
+// Far zoom: individual items paint nothing, and devices are aggregated into
+// screen-space cells drawn as one disc per cell, sized by device count and
+// coloured by the most common device type.
+void NetworkCanvas::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    const QTransform world = painter->worldTransform();
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(world);
+    if (lod >= DeviceItem::LOD_CLUSTER) return;
+
+    struct Cluster {
+        QPointF sum;
+        int     count = 0;
+        int     byType[4] = {0, 0, 0, 0};
+    };
+    const qreal cell = 32.0 / lod; // 32 px cells, in scene units
+    QHash<quint64, Cluster> clusters;
+    for (const DeviceItem *item : std::as_const(m_deviceItems)) {
+        const QPointF pos = item->pos();
+        if (!rect.contains(pos)) continue;
+        // Cell coordinates go negative left of and above the origin, so pack
+        // them as unsigned halves: shifting a negative signed value is UB
+        const quint64 key = (quint64(quint32(qint32(std::floor(pos.x() / cell)))) << 32)
+                          | quint32(qint32(std::floor(pos.y() / cell)));
+        Cluster &c = clusters[key];
+        c.sum += pos;
+        ++c.count;
+        ++c.byType[static_cast<int>(item->device()->deviceType())];
+    }
+
+    painter->save();
+    painter->setWorldTransform(QTransform()); // draw in viewport pixels
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setFont(QFont("Arial", 7));
+    for (const Cluster &c : std::as_const(clusters)) {
+        int dominant = 0;
+        for (int t = 1; t < 4; ++t)
+            if (c.byType[t] > c.byType[dominant]) dominant = t;
+
+        const QPointF centre = world.map(c.sum / c.count);
+        const qreal   radius = qMin(15.0, 3.0 + 2.0 * std::sqrt(qreal(c.count)));
+        painter->setPen(QPen(Qt::white, 1));
+        painter->setBrush(DeviceItem::typeColor(static_cast<Device::Type>(dominant)));
+        painter->drawEllipse(centre, radius, radius);
+        if (c.count > 1) {
+            painter->setPen(Qt::white);
+            painter->drawText(QRectF(centre.x() - radius, centre.y() - radius, 2 * radius, 2 * radius),
+                              Qt::AlignCenter, QString::number(c.count));
+        }
+    }
+    painter->restore();
+}
+
 // ---------------------------------------------------------------------------
 // Signal wiring
 // ---------------------------------------------------------------------------
@@ -191,6 +388,9 @@ void NetworkCanvas::connectItemSignals(DeviceItem *item)
     connect(item, &DeviceItem::deleteRequested, this, [this, item]() {
         deleteDeviceItem(item);
     }, Qt::QueuedConnection);
+    connect(item, &DeviceItem::configured, this, [this, item]() {
+        m_network->notifyDeviceChanged(item->device()->id());
+    });
 }
 
 // ---------------------------------------------------------------------------
@@ -222,13 +422,7 @@ void NetworkCanvas::placeDevice(Device::Type type, const QPointF &scenePos)
     }
 
     dev->setPosition(scenePos.x(), scenePos.y());
-    m_network->addDevice(dev);
-
-    auto *item = new DeviceItem(dev);
-    item->setPos(scenePos);
-    m_scene->addItem(item);
-    m_deviceItems.insert(dev->id(), item);
-    connectItemSignals(item);
+    m_network->addDevice(dev); // onDeviceAdded creates the item
 
     emit statusMessage(QString("Placed %1. Double-click to configure.").arg(name));
 }
@@ -271,11 +465,7 @@ void NetworkCanvas::finishConnect(DeviceItem *item)
     link.interface1 = if1;
     link.device2Id = dst->device()->id();
     link.interface2 = if2;
-    m_network->addLink(link);
-
-    auto *litem = new LinkItem(link, src, dst);
-    m_scene->addItem(litem);
-    m_linkItems.insert(link.id, litem);
+    m_network->addLink(link); // onLinkAdded creates the item
 
     emit statusMessage(QString("Connected %1 (%2) <-> %3 (%4)")
                        .arg(src->device()->name(), if1,
@@ -287,36 +477,15 @@ void NetworkCanvas::finishConnect(DeviceItem *item)
 // ---------------------------------------------------------------------------
 void NetworkCanvas::deleteDeviceItem(DeviceItem *item)
 {
-    const QString devId = item->device()->id();
-
-    // Remove all link items connected to this device
-    const QList<const Link *> links = m_network->linksForDevice(devId);
-    for (const Link *link : links) {
-        if (LinkItem *li = m_linkItems.take(link->id)) {
-            li->sourceItem()->removeLink(li);
-            li->destItem()->removeLink(li);
-            m_scene->removeItem(li);
-            delete li;
-        }
-    }
-
-    m_deviceItems.remove(devId);
-    m_scene->removeItem(item);
-    delete item;
-
-    m_network->removeDevice(devId); // also removes links from model
+    // The model reports the device's links and then the device as removed;
+    // the handlers above drop the matching items.
+    m_network->removeDevice(item->device()->id());
     emit statusMessage("Device deleted.");
 }
 
 void NetworkCanvas::deleteLinkItem(LinkItem *item)
 {
-    const QString linkId = item->link().id;
-    item->sourceItem()->removeLink(item);
-    item->destItem()->removeLink(item);
-    m_scene->removeItem(item);
-    m_linkItems.remove(linkId);
-    delete item;
-    m_network->removeLink(linkId);
+    m_network->removeLink(item->link().id);
     emit statusMessage("Link deleted.");
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 #include <QGraphicsView>
 #include <QHash>
+#include <QPair>
+#include <QPointF>
 #include "models/Device.h"
 
 class Network;
@@ -19,19 +21,38 @@ public:
     void setMode(Mode mode);
     Mode mode() const { return m_mode; }
 
-    void rebuildFromNetwork();
-    void clear();
+    // Moves device items (and so the devices) to the given scene positions,
+    // growing the scene rect to fit; used to stream auto-layout progress.
+    void applyPositions(const QList<QPair<QString, QPointF>> &positions);
+    void fitToNetwork();
 
 signals:
     void statusMessage(const QString &msg);
 
 protected:
     void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
     void dragEnterEvent(QDragEnterEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
     void drawBackground(QPainter *painter, const QRectF &rect) override;
+    void drawForeground(QPainter *painter, const QRectF &rect) override;
 
 private:
+    // Network change handlers: each touches only the items named by id
+    void onDeviceAdded(const QString &deviceId);
+    void onDeviceRemoved(const QString &deviceId);
+    void onDeviceChanged(const QString &deviceId);
+    void onLinkAdded(const QString &linkId);
+    void onLinkRemoved(const QString &linkId);
+    void syncWithNetwork();
+
+    DeviceItem *addDeviceItem(Device *device);
+    LinkItem   *addLinkItem(const Link &link);
+    void        removeDeviceItem(const QString &deviceId);
+    void        removeLinkItem(const QString &linkId);
+
     void connectItemSignals(DeviceItem *item);
     void placeDevice(Device::Type type, const QPointF &scenePos);
     void startConnect(DeviceItem *item);
@@ -49,4 +70,9 @@ private:
     QHash<QString, DeviceItem *> m_deviceItems; // device id  -> item
     QHash<QString, LinkItem *>   m_linkItems;   // link id    -> item
     int                          m_counter = 0;
+
+    // Large selections are dragged with the scene index off; keeping the
+    // BSP tree current for every moved item costs more than rebuilding it.
+    static constexpr int DRAG_NOINDEX_THRESHOLD = 32;
+    bool                         m_indexSuspended = false;
 };
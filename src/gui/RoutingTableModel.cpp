@@ -0,0 +1,121 @@
+#include "gui/RoutingTableModel.h"
+#include <algorithm>
+
+RoutingTableModel::RoutingTableModel(QObject *parent)
+    : QAbstractTableModel(parent) {}
+
+void RoutingTableModel::setResult(const SimulationResult &result)
+{
+    beginResetModel();
+    m_routers = result.routerResults;
+    m_filter  = -1;
+    rebuildOffsets();
+    endResetModel();
+}
+
+void RoutingTableModel::clear()
+{
+    setResult({});
+}
+
+void RoutingTableModel::setRouterFilter(int routerIndex)
+{
+    if (routerIndex >= m_routers.size()) routerIndex = -1;
+    if (routerIndex == m_filter) return;
+    beginResetModel();
+    m_filter = routerIndex;
+    rebuildOffsets();
+    endResetModel();
+}
+
+void RoutingTableModel::rebuildOffsets()
+{
+    m_visible.clear();
+    m_offsets.clear();
+    m_total  = 0;
+    m_loaded = 0;
+
+    for (int r = 0; r < m_routers.size(); ++r) {
+        if (m_filter >= 0 && r != m_filter) continue;
+        m_visible.append(r);
+        m_offsets.append(m_total);
+        m_total += m_routers[r].routingTable.size();
+    }
+    m_offsets.append(m_total);
+    m_loaded = static_cast<int>(std::min<qint64>(m_total, FETCH_BATCH));
+}
+
+QPair<int, int> RoutingTableModel::locate(int row) const
+{
+    // Last router whose first row is <= row
+    const auto it = std::upper_bound(m_offsets.begin(), m_offsets.end() - 1, qint64(row)) - 1;
+    const int v = static_cast<int>(it - m_offsets.begin());
+    return {m_visible[v], static_cast<int>(row - *it)};
+}
+
+// ---------------------------------------------------------------------------
+int RoutingTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_loaded;
+}
+
+int RoutingTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant RoutingTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_loaded) return {};
+    if (role != Qt::DisplayRole && role != Qt::TextAlignmentRole) return {};
+
+    if (role == Qt::TextAlignmentRole)
+        return index.column() == MetricCol ? QVariant(Qt::AlignRight | Qt::AlignVCenter) : QVariant();
+
+    const auto [r, e] = locate(index.row());
+    const RouterSimResult &router = m_routers[r];
+    const RoutingEntry    &entry  = router.routingTable[e];
+    switch (index.column()) {
+        case RouterCol:      return router.routerName;
+        case DestinationCol: return entry.destination;
+        case MaskCol:        return entry.mask;
+        case NextHopCol:     return entry.nextHop;
+        case InterfaceCol:   return entry.exitInterface;
+        case MetricCol:      return entry.metric;
+        case ProtocolCol:    return entry.protocol;
+    }
+    return {};
+}
+
+QVariant RoutingTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return {};
+    switch (section) {
+        case RouterCol:      return "Router";
+        case DestinationCol: return "Destination";
+        case MaskCol:        return "Mask";
+        case NextHopCol:     return "Next Hop";
+        case InterfaceCol:   return "Interface";
+        case MetricCol:      return "Metric";
+        case ProtocolCol:    return "Protocol";
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// Lazy population
+// ---------------------------------------------------------------------------
+bool RoutingTableModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_loaded < m_total;
+}
+
+void RoutingTableModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid()) return;
+    const int batch = static_cast<int>(std::min<qint64>(m_total - m_loaded, FETCH_BATCH));
+    if (batch <= 0) return;
+    beginInsertRows({}, m_loaded, m_loaded + batch - 1);
+    m_loaded += batch;
+    endInsertRows();
+}
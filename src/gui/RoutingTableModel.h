@@ -0,0 +1,56 @@
+#pragma once
+#include <QAbstractTableModel>
+#include <QList>
+#include "routing/RoutingEngine.h"
+
+// ---------------------------------------------------------------------------
+// RoutingTableModel
+//
+// Every router's computed routes as one flat table (router name first),
+// optionally filtered to a single router.  Rows are resolved on demand from
+// the SimulationResult through per-router offsets, and handed to the view in
+// batches via canFetchMore()/fetchMore(), so millions of routes cost no more
+// than the rows actually scrolled into view.
+// ---------------------------------------------------------------------------
+class RoutingTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column { RouterCol, DestinationCol, MaskCol, NextHopCol, InterfaceCol, MetricCol,
+                  ProtocolCol, ColumnCount };
+
+    explicit RoutingTableModel(QObject *parent = nullptr);
+
+    void setResult(const SimulationResult &result);
+    void clear();
+
+    // -1 shows all routers; otherwise an index into result.routerResults
+    void setRouterFilter(int routerIndex);
+    int  routerFilter() const { return m_filter; }
+
+    const QList<RouterSimResult> &routers() const { return m_routers; }
+    qint64 totalRoutes() const { return m_total; } // rows under the current filter
+
+    int      rowCount(const QModelIndex &parent = {}) const override;
+    int      columnCount(const QModelIndex &parent = {}) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+private:
+    static constexpr int FETCH_BATCH = 1000;
+
+    void rebuildOffsets();
+    // Router index and entry index for a visible row
+    QPair<int, int> locate(int row) const;
+
+    QList<RouterSimResult> m_routers;
+    QList<int>             m_visible;  // router indexes shown, in order
+    QList<qint64>          m_offsets;  // first row of each visible router, plus the total
+    qint64                 m_total  = 0;
+    int                    m_loaded = 0; // rows exposed to the view so far
+    int                    m_filter = -1;
+};
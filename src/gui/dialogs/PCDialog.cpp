@@ -17,15 +17,18 @@ PCDialog::PCDialog(PC *pc, QWidget *parent)
     m_ipEdit      = new QLineEdit(pc->ipAddress());
     m_maskEdit    = new QLineEdit(pc->subnetMask());
     m_gatewayEdit = new QLineEdit(pc->defaultGateway());
+    m_groupsEdit  = new QLineEdit(pc->multicastGroups().join(", "));
 
     m_ipEdit->setPlaceholderText("e.g. 192.168.1.10");
     m_maskEdit->setPlaceholderText("e.g. 255.255.255.0");
     m_gatewayEdit->setPlaceholderText("e.g. 192.168.1.1");
+    m_groupsEdit->setPlaceholderText("e.g. 239.1.1.1, 239.1.1.2");
 
     form->addRow("Name:",            m_nameEdit);
     form->addRow("IP Address:",      m_ipEdit);
     form->addRow("Subnet Mask:",     m_maskEdit);
     form->addRow("Default Gateway:", m_gatewayEdit);
+    form->addRow("Multicast Groups:", m_groupsEdit);
     layout->addLayout(form);
 
     auto *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
@@ -40,6 +43,10 @@ void PCDialog::accept()
     const QString mask    = m_maskEdit->text().trimmed();
     const QString gateway = m_gatewayEdit->text().trimmed();
 
+    QStringList groups;
+    for (const QString &g : m_groupsEdit->text().split(',', Qt::SkipEmptyParts))
+        groups.append(g.trimmed());
+
     if (!ip.isEmpty() && !IpUtils::isValidIp(ip)) {
         QMessageBox::warning(this, "Invalid Input", "Invalid IP address: " + ip);
         return;
@@ -52,12 +59,19 @@ void PCDialog::accept()
         QMessageBox::warning(this, "Invalid Input", "Invalid gateway address: " + gateway);
         return;
     }
+    for (const QString &g : groups) {
+        if (!IpUtils::isValidIp(g)) {
+            QMessageBox::warning(this, "Invalid Input", "Invalid multicast group: " + g);
+            return;
+        }
+    }
 
     m_pc->setName(m_nameEdit->text().trimmed());
     if (!m_pc->interfaces().isEmpty()) {
-        m_pc->interfaces()[0].ipAddress  = ip;
-        m_pc->interfaces()[0].subnetMask = mask;
+        m_pc->interfaces()[0].setIpAddress(ip);
+        m_pc->interfaces()[0].setSubnetMask(mask);
     }
     m_pc->setDefaultGateway(gateway);
+    m_pc->setMulticastGroups(groups);
     QDialog::accept();
 }
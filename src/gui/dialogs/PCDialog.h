@@ -17,4 +17,5 @@ private:
     QLineEdit *m_ipEdit      = nullptr;
     QLineEdit *m_maskEdit    = nullptr;
     QLineEdit *m_gatewayEdit = nullptr;
+    QLineEdit *m_groupsEdit  = nullptr;
 };
@@ -57,7 +57,8 @@ void RouterDialog::buildInterfacesTab(QTabWidget *tabs)
     grid->addWidget(new QLabel("<b>Interface</b>"), 0, 0);
     grid->addWidget(new QLabel("<b>IP Address</b>"), 0, 1);
     grid->addWidget(new QLabel("<b>Subnet Mask</b>"), 0, 2);
-    grid->addWidget(new QLabel("<b>OSPF Cost</b>"), 0, 3);
+    grid->addWidget(new QLabel("<b>IPv6 Address</b>"), 0, 3);
+    grid->addWidget(new QLabel("<b>OSPF Cost</b>"), 0, 4);
 
     const auto &ifaces = m_router->interfaces();
     for (int i = 0; i < ifaces.size(); ++i) {
@@ -65,18 +66,22 @@ void RouterDialog::buildInterfacesTab(QTabWidget *tabs)
 
         auto *ipEdit   = new QLineEdit;
         auto *maskEdit = new QLineEdit;
+        auto *ipv6Edit = new QLineEdit;
         auto *costEdit = new QLineEdit;
         costEdit->setFixedWidth(60);
         ipEdit->setPlaceholderText("e.g. 192.168.1.1");
         maskEdit->setPlaceholderText("e.g. 255.255.255.0");
+        ipv6Edit->setPlaceholderText("e.g. 2001:db8:1::1/64");
         costEdit->setPlaceholderText("1");
 
         grid->addWidget(ipEdit,   i + 1, 1);
         grid->addWidget(maskEdit, i + 1, 2);
-        grid->addWidget(costEdit, i + 1, 3);
+        grid->addWidget(ipv6Edit, i + 1, 3);
+        grid->addWidget(costEdit, i + 1, 4);
 
         m_ifIpEdits.append(ipEdit);
         m_ifMaskEdits.append(maskEdit);
+        m_ifIpv6Edits.append(ipv6Edit);
         m_ifCostEdits.append(costEdit);
     }
 
@@ -183,8 +188,9 @@ void RouterDialog::populateFields()
 {
     const auto &ifaces = m_router->interfaces();
     for (int i = 0; i < ifaces.size() && i < m_ifIpEdits.size(); ++i) {
-        m_ifIpEdits[i]->setText(ifaces[i].ipAddress);
-        m_ifMaskEdits[i]->setText(ifaces[i].subnetMask);
+        m_ifIpEdits[i]->setText(ifaces[i].ipAddress());
+        m_ifMaskEdits[i]->setText(ifaces[i].subnetMask());
+        m_ifIpv6Edits[i]->setText(ifaces[i].ipv6Address());
         m_ifCostEdits[i]->setText(ifaces[i].ospfCost > 0
                                   ? QString::number(ifaces[i].ospfCost) : QString());
     }
@@ -264,6 +270,14 @@ bool RouterDialog::validateAndApply()
                 QString("Invalid subnet mask on %1: %2").arg(ifaces[i].name, mask));
             return false;
         }
+        const QString ipv6 = m_ifIpv6Edits[i]->text().trimmed();
+        IpUtils::ParseError err = IpUtils::ParseError::None;
+        if (!ipv6.isEmpty() && !IpUtils::parseCidr6(ipv6, nullptr, nullptr, &err)) {
+            QMessageBox::warning(this, "Invalid Input",
+                QString("Invalid IPv6 address on %1: %2 (%3)")
+                    .arg(ifaces[i].name, ipv6, QString::fromLatin1(IpUtils::errorString(err))));
+            return false;
+        }
     }
 
     // Apply
@@ -271,8 +285,9 @@ bool RouterDialog::validateAndApply()
 
     auto &ifaceList = m_router->interfaces();
     for (int i = 0; i < ifaceList.size() && i < m_ifIpEdits.size(); ++i) {
-        ifaceList[i].ipAddress  = m_ifIpEdits[i]->text().trimmed();
-        ifaceList[i].subnetMask = m_ifMaskEdits[i]->text().trimmed();
+        ifaceList[i].setIpAddress(m_ifIpEdits[i]->text().trimmed());
+        ifaceList[i].setSubnetMask(m_ifMaskEdits[i]->text().trimmed());
+        ifaceList[i].setIpv6Address(m_ifIpv6Edits[i]->text().trimmed());
         const QString costStr = m_ifCostEdits[i]->text().trimmed();
         ifaceList[i].ospfCost = costStr.isEmpty() ? 1 : costStr.toInt();
     }
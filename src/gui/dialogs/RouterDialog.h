@@ -35,6 +35,7 @@ private:
     // Interfaces tab  (one row per interface)
     QList<QLineEdit *> m_ifIpEdits;
     QList<QLineEdit *> m_ifMaskEdits;
+    QList<QLineEdit *> m_ifIpv6Edits;
     QList<QLineEdit *> m_ifCostEdits;
 
     // Routing tab
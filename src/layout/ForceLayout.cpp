@@ -0,0 +1,311 @@
+#include "layout/ForceLayout.h"
+#include "models/Network.h"
+#include "utils/Trace.h"
+#include <QHash>
+#include <QSet>
+#include <QRandomGenerator>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cmath>
+
+// ---------------------------------------------------------------------------
+// Barnes-Hut quadtree.  Rebuilt every iteration; read-only (and therefore
+// shared by the worker threads) while forces are evaluated.
+// ---------------------------------------------------------------------------
+namespace {
+
+struct QuadNode {
+    qreal cx = 0, cy = 0, half = 0; // square cell
+    qreal sx = 0, sy = 0;           // sum of body positions (centre of mass * mass)
+    int   mass  = 0;
+    int   body  = -1;               // first body stored in a leaf
+    int   child = -1;               // first of four children, -1 for a leaf
+};
+
+class QuadTree
+{
+public:
+    QuadTree(const QList<qreal> &x, const QList<qreal> &y) : m_x(x), m_y(y)
+    {
+        if (x.isEmpty()) return;
+        const auto [minX, maxX] = std::minmax_element(x.begin(), x.end());
+        const auto [minY, maxY] = std::minmax_element(y.begin(), y.end());
+        QuadNode root;
+        root.cx   = (*minX + *maxX) / 2;
+        root.cy   = (*minY + *maxY) / 2;
+        root.half = std::max({*maxX - *minX, *maxY - *minY, qreal(1)}) / 2 + 1;
+        m_nodes.reserve(x.size() * 2);
+        m_nodes.append(root);
+        for (int i = 0; i < x.size(); ++i) insert(0, i, 0);
+    }
+
+    // Fruchterman-Reingold repulsion k2/d on body i from every other body.
+    void repulsion(int i, qreal theta2, qreal k2, qreal &fx, qreal &fy) const
+    {
+        int stack[128];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const QuadNode &n = m_nodes[stack[--top]];
+            if (n.mass == 0) continue;
+            if (n.child < 0 && n.body == i && n.mass == 1) continue;
+
+            qreal dx = m_x[i] - n.sx / n.mass;
+            qreal dy = m_y[i] - n.sy / n.mass;
+            qreal d2 = dx * dx + dy * dy;
+
+            const qreal size = 2 * n.half;
+            if (n.child >= 0 && size * size >= theta2 * d2 && top + 4 <= 128) {
+                for (int c = 0; c < 4; ++c) stack[top++] = n.child + c;
+                continue;
+            }
+            if (d2 < 1e-6) { // coincident: push apart along a body-specific direction
+                dx = std::cos(i * 2.399963);
+                dy = std::sin(i * 2.399963);
+                d2 = 1;
+            }
+            const qreal f = k2 * n.mass / d2;
+            fx += dx * f;
+            fy += dy * f;
+        }
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 40;
+
+    int quadrant(const QuadNode &n, int body) const
+    {
+        return (m_x[body] >= n.cx ? 1 : 0) | (m_y[body] >= n.cy ? 2 : 0);
+    }
+
+    void insert(int node, int body, int depth)
+    {
+        for (;;) {
+            QuadNode &n = m_nodes[node];
+            ++n.mass;
+            n.sx += m_x[body];
+            n.sy += m_y[body];
+
+            if (n.child < 0) {
+                if (n.mass == 1) { n.body = body; return; }
+                if (depth >= MAX_DEPTH) return; // (near-)coincident bodies share a leaf
+
+                // Split: push the resident body down, then continue with 'body'
+                const int resident = n.body;
+                const QuadNode parent = n;
+                m_nodes[node].body  = -1;
+                m_nodes[node].child = static_cast<int>(m_nodes.size());
+                for (int q = 0; q < 4; ++q) {
+                    QuadNode c;
+                    c.half = parent.half / 2;
+                    c.cx   = parent.cx + ((q & 1) ? c.half : -c.half);
+                    c.cy   = parent.cy + ((q & 2) ? c.half : -c.half);
+                    m_nodes.append(c);
+                }
+                const int target = m_nodes[node].child + quadrant(m_nodes[node], resident);
+                m_nodes[target].mass = 1;
+                m_nodes[target].sx   = m_x[resident];
+                m_nodes[target].sy   = m_y[resident];
+                m_nodes[target].body = resident;
+            }
+            node = m_nodes[node].child + quadrant(m_nodes[node], body);
+            ++depth;
+        }
+    }
+
+    const QList<qreal> &m_x;
+    const QList<qreal> &m_y;
+    QList<QuadNode>     m_nodes;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+ForceLayout::ForceLayout(Network *network, const LayoutOptions &options)
+    : m_options(options)
+{
+    QHash<QString, int> index;
+    QSet<QPair<qint64, qint64>> distinct;
+    // devices() and links() come in hash order, which Qt seeds per process;
+    // order both by id so a given seed always lays out the same way
+    QList<Device *> devices = network->devices();
+    std::sort(devices.begin(), devices.end(),
+              [](const Device *a, const Device *b) { return a->id() < b->id(); });
+    for (const Device *d : devices) {
+        index.insert(d->id(), static_cast<int>(m_ids.size()));
+        m_ids.append(d->id());
+        m_x.append(d->x());
+        m_y.append(d->y());
+        distinct.insert({qRound64(d->x()), qRound64(d->y())});
+    }
+    // Treat the network as already laid out unless most devices share a spot
+    const bool placed = distinct.size() * 2 > m_ids.size();
+
+    for (const Link *l : network->links()) {
+        const int a = index.value(l->device1Id, -1);
+        const int b = index.value(l->device2Id, -1);
+        if (a >= 0 && b >= 0 && a != b) m_edges.append({a, b});
+    }
+    std::sort(m_edges.begin(), m_edges.end());
+
+    m_dx.resize(m_ids.size());
+    m_dy.resize(m_ids.size());
+    if (m_options.mode == LayoutOptions::Mode::Hierarchical) assignLayers(network);
+    initialPositions(placed);
+
+    // Cool geometrically from the start temperature to 1% of an edge length
+    const qreal k = m_options.idealEdgeLength;
+    m_temperature = placed ? 2 * k : k * (1 + 0.1 * std::sqrt(qreal(m_ids.size())));
+    m_cooling     = std::pow(0.01 * k / m_temperature, 1.0 / std::max(1, m_options.maxIterations));
+    m_finished    = m_ids.isEmpty();
+}
+
+// Rows from the top: transit routers (core), routers serving LANs
+// (distribution), switches/hubs (access), then PCs.  Empty rows are skipped.
+void ForceLayout::assignLayers(Network *network)
+{
+    QList<int> raw;
+    for (const QString &id : m_ids) {
+        const Device *d = network->device(id);
+        int layer = 3;
+        switch (d->deviceType()) {
+            case Device::Type::Router: {
+                layer = 0;
+                for (const Link *l : network->linksForDevice(id))
+                    if (!qobject_cast<Router *>(network->neighbor(l, id))) { layer = 1; break; }
+                break;
+            }
+            case Device::Type::Switch:
+            case Device::Type::Hub: layer = 2; break;
+            case Device::Type::PC:  layer = 3; break;
+        }
+        raw.append(layer);
+    }
+
+    int rank[4] = {-1, -1, -1, -1};
+    for (int l : raw) rank[l] = 0;
+    int next = 0;
+    for (int &r : rank)
+        if (r == 0) r = next++;
+    for (int l : raw) m_layer.append(rank[l]);
+}
+
+void ForceLayout::initialPositions(bool placed)
+{
+    const int   n = nodeCount();
+    const qreal k = m_options.idealEdgeLength;
+    QRandomGenerator rng(m_options.seed);
+
+    if (!placed) {
+        // Spread over a square sized for ~one edge length per device
+        const qreal side = k * std::sqrt(qreal(std::max(n, 1)));
+        for (int i = 0; i < n; ++i) {
+            m_x[i] = (rng.generateDouble() - 0.5) * side;
+            m_y[i] = (rng.generateDouble() - 0.5) * side;
+        }
+    } else {
+        // Keep the current arrangement; separate exact duplicates slightly
+        QSet<QPair<qint64, qint64>> seen;
+        for (int i = 0; i < n; ++i)
+            if (seen.contains({qRound64(m_x[i]), qRound64(m_y[i])})) {
+                m_x[i] += (rng.generateDouble() - 0.5) * k;
+                m_y[i] += (rng.generateDouble() - 0.5) * k;
+            } else {
+                seen.insert({qRound64(m_x[i]), qRound64(m_y[i])});
+            }
+    }
+
+    if (!m_layer.isEmpty())
+        for (int i = 0; i < n; ++i) m_y[i] = m_layer[i] * 2 * k;
+}
+
+// ---------------------------------------------------------------------------
+// One iteration
+// ---------------------------------------------------------------------------
+void ForceLayout::computeRepulsion()
+{
+    const QuadTree tree(m_x, m_y);
+    const qreal theta2 = m_options.theta * m_options.theta;
+    // Scaled down from the textbook k^2: with every pair repelling, the full
+    // constant stretches links to ~3k; 0.2 k^2 settles them near 1.5k
+    const qreal k2     = 0.2 * m_options.idealEdgeLength * m_options.idealEdgeLength;
+
+    // Bodies are independent given the tree; hand them out in chunks
+    constexpr int CHUNK = 256;
+    QList<int> chunks;
+    for (int start = 0; start < nodeCount(); start += CHUNK) chunks.append(start);
+
+    QtConcurrent::blockingMap(chunks, [&](int start) {
+        TRACE_SCOPE("ForceLayout::repulsion");
+        const int end = std::min(start + CHUNK, nodeCount());
+        for (int i = start; i < end; ++i) {
+            qreal fx = 0, fy = 0;
+            tree.repulsion(i, theta2, k2, fx, fy);
+            m_dx[i] = fx;
+            m_dy[i] = fy;
+        }
+    });
+}
+
+bool ForceLayout::step()
+{
+    if (m_finished) return false;
+
+    const int   n = nodeCount();
+    const qreal k = m_options.idealEdgeLength;
+
+    computeRepulsion();
+
+    // Attraction d^2/k along links
+    for (const auto &e : std::as_const(m_edges)) {
+        const qreal dx = m_x[e.first] - m_x[e.second];
+        const qreal dy = m_y[e.first] - m_y[e.second];
+        const qreal d  = std::max(std::sqrt(dx * dx + dy * dy), qreal(0.01));
+        const qreal f  = d / k; // (d^2/k) / d
+        m_dx[e.first]  -= dx * f;  m_dy[e.first]  -= dy * f;
+        m_dx[e.second] += dx * f;  m_dy[e.second] += dy * f;
+    }
+
+    // Move, capped by the temperature; a weak pull to the origin keeps
+    // disconnected components from drifting apart indefinitely
+    qreal maxMove = 0;
+    for (int i = 0; i < n; ++i) {
+        qreal dx = m_dx[i] - 0.01 * m_x[i];
+        qreal dy = m_dy[i] - 0.01 * m_y[i];
+        if (!m_layer.isEmpty()) dy = 0; // rows are fixed in hierarchical mode
+        const qreal len = std::sqrt(dx * dx + dy * dy);
+        if (len < 1e-9) continue;
+        const qreal move = std::min(len, m_temperature);
+        m_x[i] += dx / len * move;
+        m_y[i] += dy / len * move;
+        maxMove = std::max(maxMove, move);
+    }
+
+    m_temperature *= m_cooling;
+    ++m_iteration;
+    if (m_iteration >= m_options.maxIterations || (m_iteration > 10 && maxMove < 0.005 * k))
+        m_finished = true;
+    return !m_finished;
+}
+
+// ---------------------------------------------------------------------------
+QList<QPair<QString, QPointF>> ForceLayout::positions() const
+{
+    QList<QPair<QString, QPointF>> result;
+    result.reserve(m_ids.size());
+    for (int i = 0; i < nodeCount(); ++i) result.append({m_ids[i], position(i)});
+    return result;
+}
+
+void ForceLayout::apply(Network *network) const
+{
+    for (int i = 0; i < nodeCount(); ++i)
+        if (Device *d = network->device(m_ids[i])) d->setPosition(m_x[i], m_y[i]);
+}
+
+void ForceLayout::run(Network *network, const LayoutOptions &options)
+{
+    ForceLayout layout(network, options);
+    while (layout.step()) {}
+    layout.apply(network);
+}
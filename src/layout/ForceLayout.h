@@ -0,0 +1,69 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPointF>
+#include <QPair>
+
+class Network;
+
+struct LayoutOptions {
+    enum class Mode {
+        ForceDirected, // free 2-D force-directed placement
+        Hierarchical   // core / distribution / access / host rows, x by force
+    };
+
+    Mode    mode            = Mode::ForceDirected;
+    qreal   idealEdgeLength = 150.0; // preferred distance between linked devices
+    qreal   theta           = 0.9;   // Barnes-Hut opening angle (0 = exact)
+    int     maxIterations   = 400;
+    quint32 seed            = 1;     // for the initial spread of unplaced devices
+};
+
+// ---------------------------------------------------------------------------
+// ForceLayout
+//
+// Fruchterman-Reingold layout with Barnes-Hut (quadtree) repulsion, so one
+// iteration costs O(n log n).  Repulsion is computed in parallel.  The graph
+// and starting positions are copied from the Network at construction, so the
+// layout can be stepped incrementally and its intermediate positions shown
+// while the Network stays untouched until apply().
+// ---------------------------------------------------------------------------
+class ForceLayout
+{
+public:
+    explicit ForceLayout(Network *network, const LayoutOptions &options = {});
+
+    // Runs one iteration; returns false once the layout has converged or hit
+    // maxIterations (further calls do nothing).
+    bool step();
+
+    bool isFinished() const { return m_finished; }
+    int  iteration()  const { return m_iteration; }
+    int  nodeCount()  const { return static_cast<int>(m_ids.size()); }
+
+    const QStringList &deviceIds() const { return m_ids; }
+    QPointF position(int i) const        { return {m_x[i], m_y[i]}; }
+    QList<QPair<QString, QPointF>> positions() const;
+
+    void apply(Network *network) const; // Device::setPosition for every device
+
+    // Steps to completion and applies the result.
+    static void run(Network *network, const LayoutOptions &options = {});
+
+private:
+    void assignLayers(Network *network);
+    void initialPositions(bool placed);
+    void computeRepulsion();
+
+    LayoutOptions      m_options;
+    QStringList        m_ids;
+    QList<QPair<int, int>> m_edges;
+    QList<qreal>       m_x, m_y;
+    QList<qreal>       m_dx, m_dy;    // displacement accumulated this iteration
+    QList<int>         m_layer;       // hierarchical mode only
+    qreal              m_temperature = 0;
+    qreal              m_cooling     = 1;
+    int                m_iteration   = 0;
+    bool               m_finished    = false;
+};
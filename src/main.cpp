@@ -1,5 +1,7 @@
 #include <QApplication>
 #include "gui/MainWindow.h"
+#include "utils/Trace.h"
+#include <iostream>
 
 int main(int argc, char *argv[])
 {
@@ -9,8 +11,24 @@ int main(int argc, char *argv[])
     app.setOrganizationName("NetworkEmulator");
     app.setStyle("Fusion");
 
+#ifdef NETEMU_TRACING
+    // NETEMU_TRACE=<file.json> records the whole session for Perfetto
+    const QString tracePath = qEnvironmentVariable("NETEMU_TRACE");
+    if (!tracePath.isEmpty()) Trace::start();
+#endif
+
     MainWindow window;
     window.show();
 
-    return app.exec();
+    const int status = app.exec();
+
+#ifdef NETEMU_TRACING
+    if (!tracePath.isEmpty()) {
+        Trace::stop();
+        QString error;
+        if (!Trace::writeChromeJson(tracePath, &error))
+            std::cerr << "Could not write trace: " << error.toStdString() << "\n";
+    }
+#endif
+    return status;
 }
@@ -5,12 +5,68 @@
 // ---------------------------------------------------------------------------
 // NetworkInterface
 // ---------------------------------------------------------------------------
+bool NetworkInterface::setIpAddress(const QString &ip)
+{
+    IpUtils::ParseError error;
+    m_ip    = IpUtils::parse(ip, &error);
+    m_hasIp = error == IpUtils::ParseError::None;
+    return m_hasIp || ip.isEmpty();
+}
+
+bool NetworkInterface::setSubnetMask(const QString &mask)
+{
+    IpUtils::ParseError error;
+    m_mask    = IpUtils::parse(mask, &error);
+    m_hasMask = error == IpUtils::ParseError::None;
+    m_prefix  = IpUtils::maskToPrefix(m_mask);
+    return m_hasMask || mask.isEmpty();
+}
+
+void NetworkInterface::setAddress(quint32 ip, quint32 mask)
+{
+    m_ip      = ip;
+    m_mask    = mask;
+    m_prefix  = IpUtils::maskToPrefix(mask);
+    m_hasIp   = true;
+    m_hasMask = true;
+}
+
+void NetworkInterface::clearAddress()
+{
+    m_ip = m_mask = 0;
+    m_prefix = 0;
+    m_hasIp = m_hasMask = false;
+}
+
+bool NetworkInterface::setIpv6Address(const QString &cidr)
+{
+    IpUtils::Ip6Address ip;
+    int length = -1;
+    const bool ok = IpUtils::parseCidr6(cidr, &ip, &length);
+    m_ipv6       = ok ? ip : IpUtils::Ip6Address{};
+    m_ipv6Prefix = ok ? length : -1;
+    return ok || cidr.isEmpty();
+}
+
+void NetworkInterface::setIpv6Address(const IpUtils::Ip6Address &ip, int prefixLen)
+{
+    m_ipv6       = ip;
+    m_ipv6Prefix = qBound(0, prefixLen, 128);
+}
+
+QString NetworkInterface::ipv6Address() const
+{
+    if (!hasIpv6()) return {};
+    return QString("%1/%2").arg(IpUtils::format6(m_ipv6)).arg(m_ipv6Prefix);
+}
+
 QJsonObject NetworkInterface::toJson() const
 {
     QJsonObject obj;
     obj["name"]        = name;
-    obj["ipAddress"]   = ipAddress;
-    obj["subnetMask"]  = subnetMask;
+    obj["ipAddress"]   = ipAddress();
+    obj["subnetMask"]  = subnetMask();
+    if (hasIpv6()) obj["ipv6Address"] = ipv6Address();
     obj["ospfCost"]    = ospfCost;
     obj["description"] = description;
     return obj;
@@ -20,8 +76,9 @@ NetworkInterface NetworkInterface::fromJson(const QJsonObject &obj)
 {
     NetworkInterface iface;
     iface.name        = obj["name"].toString();
-    iface.ipAddress   = obj["ipAddress"].toString();
-    iface.subnetMask  = obj["subnetMask"].toString();
+    iface.setIpAddress(obj["ipAddress"].toString());
+    iface.setSubnetMask(obj["subnetMask"].toString());
+    iface.setIpv6Address(obj["ipv6Address"].toString());
     iface.ospfCost    = obj["ospfCost"].toInt(1);
     iface.description = obj["description"].toString();
     return iface;
@@ -37,9 +94,21 @@ Device::Device(Type type, const QString &name, QObject *parent)
     , m_name(name)
 {}
 
+// Called when the device joins a Network, once its id is final, with the
+// network's pool: the id and interface names then share the pooled text
+// that the network's links use.
+void Device::internNames(StringPool &pool)
+{
+    m_idSymbol = pool.intern(m_id);
+    m_id       = pool.text(m_idSymbol);
+    for (auto &iface : m_interfaces) iface.name = pool.pooled(iface.name);
+}
+
 NetworkInterface *Device::addInterface(const QString &name)
 {
-    m_interfaces.append(NetworkInterface{name, {}, {}, 1, {}});
+    NetworkInterface iface;
+    iface.name = name;
+    m_interfaces.append(iface);
     return &m_interfaces.last();
 }
 
@@ -57,6 +126,15 @@ const NetworkInterface *Device::getInterface(const QString &name) const
     return nullptr;
 }
 
+bool Device::setInterfaceAddress(const QString &name, quint32 ip, quint32 mask)
+{
+    NetworkInterface *iface = getInterface(name);
+    if (!iface) return false;
+    iface->setAddress(ip, mask);
+    emit addressesChanged();
+    return true;
+}
+
 QJsonObject Device::toJson() const
 {
     QJsonObject obj;
@@ -94,27 +172,62 @@ Router::Router(const QString &name, QObject *parent)
         addInterface(QString("Gi0/%1").arg(i));
 }
 
-QJsonObject Router::toJson() const
+void Router::setRoutingProtocol(RoutingProtocol p)
 {
-    QJsonObject obj = Device::toJson();
-    obj["type"] = "Router";
+    if (p == m_protocol) return;
+    const RoutingProtocol previous = m_protocol;
+    m_protocol = p;
+    emit protocolChanged(previous);
+}
 
-    switch (m_protocol) {
-        case RoutingProtocol::Static: obj["protocol"] = "Static"; break;
-        case RoutingProtocol::RIPv2:  obj["protocol"] = "RIPv2";  break;
-        case RoutingProtocol::OSPF:   obj["protocol"] = "OSPF";   break;
-        case RoutingProtocol::PIM_DM: obj["protocol"] = "PIM-DM"; break;
+QString Router::protocolToString(RoutingProtocol p)
+{
+    switch (p) {
+        case RoutingProtocol::Static: return "Static";
+        case RoutingProtocol::RIPv2:  return "RIPv2";
+        case RoutingProtocol::OSPF:   return "OSPF";
+        case RoutingProtocol::PIM_DM: return "PIM-DM";
     }
+    return "Static";
+}
+
+Router::RoutingProtocol Router::protocolFromString(const QString &s)
+{
+    if (s == "RIPv2")  return RoutingProtocol::RIPv2;
+    if (s == "OSPF")   return RoutingProtocol::OSPF;
+    if (s == "PIM-DM") return RoutingProtocol::PIM_DM;
+    return RoutingProtocol::Static;
+}
+
+QJsonObject Router::StaticRoute::toJson() const
+{
+    QJsonObject ro;
+    ro["destination"] = destination;
+    ro["mask"]        = mask;
+    ro["nextHop"]     = nextHop;
+    ro["metric"]      = metric;
+    return ro;
+}
+
+Router::StaticRoute Router::StaticRoute::fromJson(const QJsonObject &ro)
+{
+    StaticRoute sr;
+    sr.destination = ro["destination"].toString();
+    sr.mask        = ro["mask"].toString();
+    sr.nextHop     = ro["nextHop"].toString();
+    sr.metric      = ro["metric"].toInt(1);
+    return sr;
+}
+
+QJsonObject Router::toJson() const
+{
+    QJsonObject obj = Device::toJson();
+    obj["type"]     = "Router";
+    obj["protocol"] = protocolToString(m_protocol);
 
     QJsonArray routes;
-    for (const auto &r : m_staticRoutes) {
-        QJsonObject ro;
-        ro["destination"] = r.destination;
-        ro["mask"]        = r.mask;
-        ro["nextHop"]     = r.nextHop;
-        ro["metric"]      = r.metric;
-        routes.append(ro);
-    }
+    for (const auto &r : m_staticRoutes)
+        routes.append(r.toJson());
     obj["staticRoutes"] = routes;
 
     QJsonObject ospf;
@@ -139,21 +252,10 @@ Router *Router::fromJson(const QJsonObject &obj, QObject *parent)
     auto *r = new Router(QString(), parent);
     r->populateInterfacesFromJson(obj);
 
-    const QString proto = obj["protocol"].toString("Static");
-    if (proto == "RIPv2")  r->m_protocol = RoutingProtocol::RIPv2;
-    else if (proto == "OSPF")   r->m_protocol = RoutingProtocol::OSPF;
-    else if (proto == "PIM-DM") r->m_protocol = RoutingProtocol::PIM_DM;
-    else                        r->m_protocol = RoutingProtocol::Static;
-
-    for (const auto &v : obj["staticRoutes"].toArray()) {
-        const QJsonObject ro = v.toObject();
-        StaticRoute sr;
-        sr.destination = ro["destination"].toString();
-        sr.mask        = ro["mask"].toString();
-        sr.nextHop     = ro["nextHop"].toString();
-        sr.metric      = ro["metric"].toInt(1);
-        r->m_staticRoutes.append(sr);
-    }
+    r->m_protocol = protocolFromString(obj["protocol"].toString("Static"));
+
+    for (const auto &v : obj["staticRoutes"].toArray())
+        r->m_staticRoutes.append(StaticRoute::fromJson(v.toObject()));
 
     const QJsonObject ospf = obj["ospfConfig"].toObject();
     r->m_ospfConfig.routerId  = ospf["routerId"].toString();
@@ -228,12 +330,12 @@ PC::PC(const QString &name, QObject *parent)
 
 QString PC::ipAddress() const
 {
-    return interfaces().isEmpty() ? QString() : interfaces().first().ipAddress;
+    return interfaces().isEmpty() ? QString() : interfaces().first().ipAddress();
 }
 
 QString PC::subnetMask() const
 {
-    return interfaces().isEmpty() ? QString() : interfaces().first().subnetMask;
+    return interfaces().isEmpty() ? QString() : interfaces().first().subnetMask();
 }
 
 QJsonObject PC::toJson() const
@@ -241,6 +343,10 @@ QJsonObject PC::toJson() const
     QJsonObject obj = Device::toJson();
     obj["type"]           = "PC";
     obj["defaultGateway"] = m_defaultGateway;
+
+    QJsonArray groups;
+    for (const auto &g : m_multicastGroups) groups.append(g);
+    obj["multicastGroups"] = groups;
     return obj;
 }
 
@@ -249,5 +355,7 @@ PC *PC::fromJson(const QJsonObject &obj, QObject *parent)
     auto *pc = new PC(QString(), parent);
     pc->populateInterfacesFromJson(obj);
     pc->m_defaultGateway = obj["defaultGateway"].toString();
+    for (const auto &v : obj["multicastGroups"].toArray())
+        pc->m_multicastGroups.append(v.toString());
     return pc;
 }
@@ -4,37 +4,71 @@
 #include <QList>
 #include <QJsonObject>
 #include "utils/IpUtils.h"
+#include "utils/StringPool.h"
 
 // ---------------------------------------------------------------------------
 // NetworkInterface
+//
+// The address and mask are held parsed; the dotted-quad strings are produced
+// only for display and JSON.  Setting an empty or malformed string leaves the
+// field unset (the setters return false for malformed input).  An interface
+// may also carry one IPv6 address with its prefix length ("2001:db8::1/64").
 // ---------------------------------------------------------------------------
 struct NetworkInterface {
     QString name;
-    QString ipAddress;
-    QString subnetMask;
     int     ospfCost   = 1;
     QString description;
 
-    bool    isConfigured() const { return !ipAddress.isEmpty() && !subnetMask.isEmpty(); }
-    quint32 ipAsUint32()   const { return IpUtils::parse(ipAddress); }
-    quint32 maskAsUint32() const { return IpUtils::parse(subnetMask); }
-    quint32 networkAddr()  const { return IpUtils::networkAddress(ipAsUint32(), maskAsUint32()); }
-    int     prefixLen()    const { return IpUtils::maskToPrefix(maskAsUint32()); }
+    bool    setIpAddress(const QString &ip);
+    bool    setSubnetMask(const QString &mask);
+    void    setAddress(quint32 ip, quint32 mask);
+    void    clearAddress();
+
+    QString ipAddress()  const { return m_hasIp   ? IpUtils::format(m_ip)   : QString(); }
+    QString subnetMask() const { return m_hasMask ? IpUtils::format(m_mask) : QString(); }
+
+    bool    hasIpAddress() const { return m_hasIp; }
+    bool    hasSubnetMask() const { return m_hasMask; }
+    bool    isConfigured() const { return m_hasIp && m_hasMask; }
+    quint32 ipAsUint32()   const { return m_ip; }
+    quint32 maskAsUint32() const { return m_mask; }
+    quint32 networkAddr()  const { return m_ip & m_mask; }
+    int     prefixLen()    const { return m_prefix; }
+
+    bool    setIpv6Address(const QString &cidr);
+    void    setIpv6Address(const IpUtils::Ip6Address &ip, int prefixLen);
+    QString ipv6Address() const; // "addr/len", or empty
+
+    bool                hasIpv6()       const { return m_ipv6Prefix >= 0; }
+    IpUtils::Ip6Address ipv6()          const { return m_ipv6; }
+    int                 ipv6PrefixLen() const { return m_ipv6Prefix; }
+    IpUtils::Ip6Address ipv6Network()   const { return m_ipv6.masked(m_ipv6Prefix); }
 
     QJsonObject toJson() const;
     static NetworkInterface fromJson(const QJsonObject &obj);
+
+private:
+    quint32 m_ip      = 0;
+    quint32 m_mask    = 0;
+    int     m_prefix  = 0;
+    bool    m_hasIp   = false;
+    bool    m_hasMask = false;
+    IpUtils::Ip6Address m_ipv6;
+    int     m_ipv6Prefix = -1; // -1 when there is no IPv6 address
 };
 
 // ---------------------------------------------------------------------------
 // RoutingEntry  (populated by simulation)
 // ---------------------------------------------------------------------------
 struct RoutingEntry {
-    QString destination;
-    QString mask;
+    QString destination;   // IPv4 network, or IPv6 network for IPv6 routes
+    QString mask;          // dotted-quad mask, or "/len" for IPv6 routes
     QString nextHop;       // IP string or "directly connected"
     QString exitInterface;
     int     metric   = 0;
-    QString protocol; // "Connected", "Static", "RIPv2", "OSPF", "PIM-DM"
+    QString protocol; // "Connected", "Static", "RIPv2", "OSPF", "OSPFv3", "PIM-DM"
+
+    bool isIpv6() const { return IpUtils::isIpv6Text(destination); }
 };
 
 // ---------------------------------------------------------------------------
@@ -49,6 +83,7 @@ public:
     Device(Type type, const QString &name = QString(), QObject *parent = nullptr);
 
     QString id()         const { return m_id; }
+    Symbol  idSymbol()   const { return m_idSymbol; } // in the owning Network's pool; invalid outside one
     Type    deviceType() const { return m_type; }
     QString name()       const { return m_name; }
     void    setName(const QString &n) { m_name = n; }
@@ -64,13 +99,25 @@ public:
     NetworkInterface *getInterface(const QString &name);
     const NetworkInterface *getInterface(const QString &name) const;
 
+    // Sets an interface's IPv4 address and reports it, so the owning
+    // Network's address index follows; false if there is no such interface
+    bool setInterfaceAddress(const QString &name, quint32 ip, quint32 mask);
+
     virtual QJsonObject toJson() const;
 
+signals:
+    // Lets Network keep its address index current
+    void addressesChanged();
+
 protected:
     void populateInterfacesFromJson(const QJsonObject &obj);
 
 private:
+    friend class Network;
+    void internNames(StringPool &pool);
+
     QString m_id;
+    Symbol  m_idSymbol;
     Type    m_type;
     QString m_name;
     qreal   m_x = 0.0;
@@ -87,11 +134,16 @@ class Router : public Device
 public:
     enum class RoutingProtocol { Static, RIPv2, OSPF, PIM_DM };
 
+    // IPv6 routes have an IPv6 destination and next hop, and the prefix
+    // length as the mask ("64" or "/64")
     struct StaticRoute {
         QString destination;
         QString mask;
         QString nextHop;
         int     metric = 1;
+
+        QJsonObject toJson() const;
+        static StaticRoute fromJson(const QJsonObject &obj);
     };
 
     struct OSPFConfig {
@@ -110,8 +162,12 @@ public:
 
     explicit Router(const QString &name = QString(), QObject *parent = nullptr);
 
+    // Protocol names as stored in files ("Static", "RIPv2", "OSPF", "PIM-DM")
+    static QString         protocolToString(RoutingProtocol p);
+    static RoutingProtocol protocolFromString(const QString &s);
+
     RoutingProtocol routingProtocol() const      { return m_protocol; }
-    void setRoutingProtocol(RoutingProtocol p)   { m_protocol = p; }
+    void setRoutingProtocol(RoutingProtocol p);
 
     QList<StaticRoute> &staticRoutes()           { return m_staticRoutes; }
     OSPFConfig         &ospfConfig()             { return m_ospfConfig; }
@@ -126,12 +182,16 @@ public:
     // Computed by simulation ------------------------------------------------
     QList<RoutingEntry>       &computedRoutingTable()       { return m_routingTable; }
     const QList<RoutingEntry> &computedRoutingTable() const { return m_routingTable; }
-    void clearRoutingTable()                         { m_routingTable.clear(); }
+    void clearRoutingTable()                         { m_routingTable.clear(); } // keeps capacity
     void addRoutingEntry(const RoutingEntry &entry)  { m_routingTable.append(entry); }
 
     QJsonObject toJson() const override;
     static Router *fromJson(const QJsonObject &obj, QObject *parent = nullptr);
 
+signals:
+    // Lets Network keep its per-protocol router lists current
+    void protocolChanged(Router::RoutingProtocol previous);
+
 private:
     RoutingProtocol    m_protocol = RoutingProtocol::Static;
     QList<StaticRoute> m_staticRoutes;
@@ -177,6 +237,10 @@ public:
     QString defaultGateway() const          { return m_defaultGateway; }
     void setDefaultGateway(const QString &g){ m_defaultGateway = g; }
 
+    // Multicast groups this PC has joined (PIM-DM receivers)
+    QStringList multicastGroups() const              { return m_multicastGroups; }
+    void setMulticastGroups(const QStringList &g)    { m_multicastGroups = g; }
+
     QString ipAddress()  const;
     QString subnetMask() const;
 
@@ -184,5 +248,6 @@ public:
     static PC *fromJson(const QJsonObject &obj, QObject *parent = nullptr);
 
 private:
-    QString m_defaultGateway;
+    QString     m_defaultGateway;
+    QStringList m_multicastGroups;
 };
@@ -0,0 +1,388 @@
+#include "models/DeviceStore.h"
+#include "models/Network.h"
+#include "utils/Trace.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+// ---------------------------------------------------------------------------
+// Building
+// ---------------------------------------------------------------------------
+DeviceHandle DeviceStore::appendDevice(Device::Type type, const QString &id, const QString &name,
+                                       qreal x, qreal y)
+{
+    DeviceColumns &cols = m_devices[int(type)];
+    const DeviceHandle h(type, int(cols.ids.size()));
+    cols.ids.append(id);
+    cols.names.append(name);
+    cols.x.append(x);
+    cols.y.append(y);
+    cols.firstInterface.append(interfaceCount());
+    cols.interfaceCount.append(0);
+
+    // Type-specific columns stay parallel to the device rows
+    if (type == Device::Type::Router) {
+        m_routers.protocol.append(quint8(Router::RoutingProtocol::Static));
+        m_routers.ospfRouterId.append(QString());
+        m_routers.ospfArea.append("0");
+        m_routers.ospfProcessId.append(1);
+    } else if (type == Device::Type::PC) {
+        m_pcs.defaultGateway.append(QString());
+    }
+
+    m_byId.insert(id, h);
+    return h;
+}
+
+// Interfaces must be appended right after their device, so a device's rows
+// are contiguous.
+void DeviceStore::appendInterface(DeviceHandle owner, const NetworkInterface &iface)
+{
+    const int row = interfaceCount();
+    m_ifaces.owner.append(owner);
+    m_ifaces.names.append(iface.name);
+    m_ifaces.ip.append(iface.ipAsUint32());
+    m_ifaces.mask.append(iface.maskAsUint32());
+    m_ifaces.flags.append(quint8((iface.hasIpAddress() ? HasIp : 0) | (iface.hasSubnetMask() ? HasMask : 0)));
+    m_ifaces.ospfCost.append(iface.ospfCost);
+    m_ifaces.link.append(-1);
+    if (!iface.description.isEmpty())
+        m_ifaces.descriptions.insert(row, iface.description);
+    if (iface.hasIpv6())
+        m_ifaces.ipv6.insert(row, {iface.ipv6(), iface.ipv6PrefixLen()});
+
+    ++m_devices[int(owner.type())].interfaceCount[owner.index()];
+}
+
+DeviceHandle DeviceStore::addDevice(const Device *device)
+{
+    const DeviceHandle h = appendDevice(device->deviceType(), device->id(), device->name(),
+                                        device->x(), device->y());
+    for (const auto &iface : device->interfaces())
+        appendInterface(h, iface);
+
+    const int row = h.index();
+    if (const auto *r = qobject_cast<const Router *>(device)) {
+        m_routers.protocol[row]      = quint8(r->routingProtocol());
+        m_routers.ospfRouterId[row]  = r->ospfConfig().routerId;
+        m_routers.ospfArea[row]      = r->ospfConfig().area;
+        m_routers.ospfProcessId[row] = r->ospfConfig().processId;
+        if (!r->staticRoutes().isEmpty())
+            m_routers.staticRoutes.insert(row, r->staticRoutes());
+        if (!r->ripv2Config().networks.isEmpty())
+            m_routers.ripNetworks.insert(row, r->ripv2Config().networks);
+        if (!r->pimdmConfig().enabledInterfaces.isEmpty())
+            m_routers.pimInterfaces.insert(row, r->pimdmConfig().enabledInterfaces);
+    } else if (const auto *pc = qobject_cast<const PC *>(device)) {
+        m_pcs.defaultGateway[row] = pc->defaultGateway();
+        if (!pc->multicastGroups().isEmpty())
+            m_pcs.multicastGroups.insert(row, pc->multicastGroups());
+    }
+    return h;
+}
+
+bool DeviceStore::addLink(const Link &link)
+{
+    const DeviceHandle a = find(link.device1Id);
+    const DeviceHandle b = find(link.device2Id);
+    if (!a.isValid() || !b.isValid()) return false;
+
+    const int end1 = findInterface(a, link.interface1);
+    const int end2 = findInterface(b, link.interface2);
+    if (end1 < 0 || end2 < 0) return false;
+
+    const int row = linkCount();
+    m_links.ids.append(link.id);
+    m_links.end1.append(end1);
+    m_links.end2.append(end2);
+    m_links.bandwidth.append(link.bandwidth);
+    m_links.delay.append(link.delay);
+    m_ifaces.link[end1] = row;
+    m_ifaces.link[end2] = row;
+    return true;
+}
+
+void DeviceStore::clear()
+{
+    *this = DeviceStore();
+}
+
+DeviceStore DeviceStore::fromNetwork(const Network *network)
+{
+    DeviceStore store;
+    store.m_name = network->name();
+    for (const Device *d : network->devices())
+        store.addDevice(d);
+    for (const Link *l : network->links())
+        store.addLink(*l);
+    return store;
+}
+
+void DeviceStore::toNetwork(Network *network) const
+{
+    QList<Device *> devices;
+    devices.reserve(deviceCount());
+    for (int t = 0; t < int(m_devices.size()); ++t)
+        for (int row = 0; row < count(Device::Type(t)); ++row)
+            devices.append(createDevice(DeviceHandle(Device::Type(t), row), network));
+
+    QList<Link> links;
+    links.reserve(linkCount());
+    for (int row = 0; row < linkCount(); ++row)
+        links.append(linkAt(row));
+
+    network->assign(m_name, devices, links);
+}
+
+// ---------------------------------------------------------------------------
+// Persistence
+// ---------------------------------------------------------------------------
+void DeviceStore::addDeviceJson(const QJsonObject &obj)
+{
+    const QString typeName = obj["type"].toString();
+    Device::Type type;
+    if      (typeName == "Router") type = Device::Type::Router;
+    else if (typeName == "Switch") type = Device::Type::Switch;
+    else if (typeName == "Hub")    type = Device::Type::Hub;
+    else if (typeName == "PC")     type = Device::Type::PC;
+    else return;
+
+    const DeviceHandle h = appendDevice(type, obj["id"].toString(), obj["name"].toString(),
+                                        obj["x"].toDouble(), obj["y"].toDouble());
+    for (const auto &v : obj["interfaces"].toArray())
+        appendInterface(h, NetworkInterface::fromJson(v.toObject()));
+
+    const int row = h.index();
+    if (type == Device::Type::Router) {
+        m_routers.protocol[row] = quint8(Router::protocolFromString(obj["protocol"].toString("Static")));
+
+        const QJsonObject ospf = obj["ospfConfig"].toObject();
+        m_routers.ospfRouterId[row]  = ospf["routerId"].toString();
+        m_routers.ospfArea[row]      = ospf["area"].toString("0");
+        m_routers.ospfProcessId[row] = ospf["processId"].toInt(1);
+
+        const QJsonArray routes = obj["staticRoutes"].toArray();
+        if (!routes.isEmpty()) {
+            QList<Router::StaticRoute> &list = m_routers.staticRoutes[row];
+            for (const auto &v : routes)
+                list.append(Router::StaticRoute::fromJson(v.toObject()));
+        }
+        const QStringList ripNets = obj["ripv2Networks"].toVariant().toStringList();
+        if (!ripNets.isEmpty()) m_routers.ripNetworks.insert(row, ripNets);
+        const QStringList pimIfaces = obj["pimDmInterfaces"].toVariant().toStringList();
+        if (!pimIfaces.isEmpty()) m_routers.pimInterfaces.insert(row, pimIfaces);
+    } else if (type == Device::Type::PC) {
+        m_pcs.defaultGateway[row] = obj["defaultGateway"].toString();
+        const QStringList groups = obj["multicastGroups"].toVariant().toStringList();
+        if (!groups.isEmpty()) m_pcs.multicastGroups.insert(row, groups);
+    }
+}
+
+void DeviceStore::fromJson(const QJsonObject &root)
+{
+    clear();
+    m_name = root["name"].toString("Untitled Network");
+    for (const auto &v : root["devices"].toArray())
+        addDeviceJson(v.toObject());
+    for (const auto &v : root["links"].toArray())
+        addLink(Link::fromJson(v.toObject()));
+}
+
+QJsonObject DeviceStore::toJson() const
+{
+    QJsonObject root;
+    root["name"] = m_name;
+
+    QJsonArray devArray;
+    for (int t = 0; t < int(m_devices.size()); ++t)
+        for (int row = 0; row < count(Device::Type(t)); ++row)
+            devArray.append(deviceJson(DeviceHandle(Device::Type(t), row)));
+    root["devices"] = devArray;
+
+    QJsonArray linkArray;
+    for (int row = 0; row < linkCount(); ++row)
+        linkArray.append(linkAt(row).toJson());
+    root["links"] = linkArray;
+    return root;
+}
+
+bool DeviceStore::load(const QString &filePath, QString *error)
+{
+    TRACE_SCOPE("DeviceStore::load");
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        if (error) *error = parseError.errorString();
+        return false;
+    }
+
+    fromJson(doc.object());
+    return true;
+}
+
+bool DeviceStore::save(const QString &filePath, QString *error) const
+{
+    TRACE_SCOPE("DeviceStore::save");
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson());
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Devices
+// ---------------------------------------------------------------------------
+int DeviceStore::deviceCount() const
+{
+    int total = 0;
+    for (const auto &cols : m_devices) total += int(cols.ids.size());
+    return total;
+}
+
+Router::RoutingProtocol DeviceStore::routingProtocol(DeviceHandle router) const
+{
+    return Router::RoutingProtocol(m_routers.protocol[router.index()]);
+}
+
+QString DeviceStore::defaultGateway(DeviceHandle pc) const
+{
+    return m_pcs.defaultGateway[pc.index()];
+}
+
+// Same layout as Device::toJson() and its overrides
+QJsonObject DeviceStore::deviceJson(DeviceHandle h) const
+{
+    QJsonObject obj;
+    obj["id"]   = id(h);
+    obj["name"] = name(h);
+    obj["x"]    = x(h);
+    obj["y"]    = y(h);
+
+    QJsonArray ifaceArray;
+    const int first = firstInterface(h);
+    for (int row = first; row < first + interfaceCount(h); ++row)
+        ifaceArray.append(interfaceAt(row).toJson());
+    obj["interfaces"] = ifaceArray;
+
+    const int row = h.index();
+    switch (h.type()) {
+    case Device::Type::Router: {
+        obj["type"]     = "Router";
+        obj["protocol"] = Router::protocolToString(routingProtocol(h));
+
+        QJsonArray routes;
+        for (const auto &r : m_routers.staticRoutes.value(row))
+            routes.append(r.toJson());
+        obj["staticRoutes"] = routes;
+
+        QJsonObject ospf;
+        ospf["routerId"]  = m_routers.ospfRouterId[row];
+        ospf["area"]      = m_routers.ospfArea[row];
+        ospf["processId"] = m_routers.ospfProcessId[row];
+        obj["ospfConfig"] = ospf;
+
+        obj["ripv2Networks"]   = QJsonArray::fromStringList(m_routers.ripNetworks.value(row));
+        obj["pimDmInterfaces"] = QJsonArray::fromStringList(m_routers.pimInterfaces.value(row));
+        break;
+    }
+    case Device::Type::Switch:
+        obj["type"] = "Switch";
+        break;
+    case Device::Type::Hub:
+        obj["type"] = "Hub";
+        break;
+    case Device::Type::PC:
+        obj["type"]            = "PC";
+        obj["defaultGateway"]  = m_pcs.defaultGateway[row];
+        obj["multicastGroups"] = QJsonArray::fromStringList(m_pcs.multicastGroups.value(row));
+        break;
+    }
+    return obj;
+}
+
+Device *DeviceStore::createDevice(DeviceHandle h, QObject *parent) const
+{
+    const QJsonObject obj = deviceJson(h);
+    switch (h.type()) {
+        case Device::Type::Router: return Router::fromJson(obj, parent);
+        case Device::Type::Switch: return Switch::fromJson(obj, parent);
+        case Device::Type::Hub:    return Hub::fromJson(obj, parent);
+        case Device::Type::PC:     return PC::fromJson(obj, parent);
+    }
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Interfaces and links
+// ---------------------------------------------------------------------------
+int DeviceStore::findInterface(DeviceHandle h, const QString &name) const
+{
+    const int first = firstInterface(h);
+    for (int row = first; row < first + interfaceCount(h); ++row)
+        if (m_ifaces.names[row] == name) return row;
+    return -1;
+}
+
+NetworkInterface DeviceStore::interfaceAt(int row) const
+{
+    NetworkInterface iface;
+    iface.name        = m_ifaces.names[row];
+    iface.ospfCost    = m_ifaces.ospfCost[row];
+    iface.description = m_ifaces.descriptions.value(row);
+
+    const quint8 flags = m_ifaces.flags[row];
+    if (flags == (HasIp | HasMask)) {
+        iface.setAddress(m_ifaces.ip[row], m_ifaces.mask[row]);
+    } else {
+        if (flags & HasIp)   iface.setIpAddress(IpUtils::format(m_ifaces.ip[row]));
+        if (flags & HasMask) iface.setSubnetMask(IpUtils::format(m_ifaces.mask[row]));
+    }
+
+    auto v6 = m_ifaces.ipv6.constFind(row);
+    if (v6 != m_ifaces.ipv6.constEnd())
+        iface.setIpv6Address(v6->first, v6->second);
+    return iface;
+}
+
+Link DeviceStore::linkAt(int row) const
+{
+    const int end1 = m_links.end1[row];
+    const int end2 = m_links.end2[row];
+    Link l;
+    l.id         = m_links.ids[row];
+    l.device1Id  = id(m_ifaces.owner[end1]);
+    l.interface1 = m_ifaces.names[end1];
+    l.device2Id  = id(m_ifaces.owner[end2]);
+    l.interface2 = m_ifaces.names[end2];
+    l.bandwidth  = m_links.bandwidth[row];
+    l.delay      = m_links.delay[row];
+    return l;
+}
+
+DeviceHandle DeviceStore::neighbor(int interfaceRow) const
+{
+    const int link = m_ifaces.link[interfaceRow];
+    if (link < 0) return {};
+    const int other = (m_links.end1[link] == interfaceRow) ? m_links.end2[link] : m_links.end1[link];
+    return m_ifaces.owner[other];
+}
+
+QList<DeviceHandle> DeviceStore::neighbors(DeviceHandle h) const
+{
+    QList<DeviceHandle> result;
+    const int first = firstInterface(h);
+    for (int row = first; row < first + interfaceCount(h); ++row) {
+        const DeviceHandle n = neighbor(row);
+        if (n.isValid()) result.append(n);
+    }
+    return result;
+}
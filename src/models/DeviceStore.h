@@ -0,0 +1,173 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QJsonObject>
+#include <array>
+#include "models/Device.h"
+#include "models/Link.h"
+
+class Network;
+
+// ---------------------------------------------------------------------------
+// DeviceHandle
+//
+// 32-bit reference to a device in a DeviceStore: the device type in the top
+// two bits and the row in that type's columns below.  The store only grows,
+// so a handle stays valid until clear().
+// ---------------------------------------------------------------------------
+struct DeviceHandle {
+    static constexpr int     TYPE_SHIFT = 30;
+    static constexpr quint32 INDEX_MASK = (1u << TYPE_SHIFT) - 1;
+    static constexpr quint32 INVALID    = 0xFFFFFFFFu;
+
+    quint32 bits = INVALID;
+
+    DeviceHandle() = default;
+    DeviceHandle(Device::Type type, int index)
+        : bits((quint32(type) << TYPE_SHIFT) | (quint32(index) & INDEX_MASK)) {}
+
+    bool         isValid() const { return bits != INVALID; }
+    Device::Type type()    const { return Device::Type(bits >> TYPE_SHIFT); }
+    int          index()   const { return int(bits & INDEX_MASK); }
+
+    friend bool operator==(DeviceHandle a, DeviceHandle b) { return a.bits == b.bits; }
+    friend bool operator!=(DeviceHandle a, DeviceHandle b) { return a.bits != b.bits; }
+};
+
+inline size_t qHash(DeviceHandle h, size_t seed = 0) { return qHash(h.bits, seed); }
+
+// ---------------------------------------------------------------------------
+// DeviceStore
+//
+// QObject-free storage for large headless models.  Each device type keeps its
+// own column arrays (structure of arrays) addressed by DeviceHandle, all
+// interfaces share one set of columns, and a link is a pair of interface
+// rows.  Loading a file this way creates no QObject and no per-device heap
+// object.  Fields most devices leave empty (static routes, RIP networks,
+// IPv6 addresses, ...) are kept in hashes keyed by row.
+//
+// Network stays the QObject facade the GUI edits and listens to; toNetwork()
+// and createDevice() build it from the store when a view needs it.  Links
+// whose endpoints do not name a known device interface are dropped.
+// ---------------------------------------------------------------------------
+class DeviceStore
+{
+public:
+    // --- Building ---
+    DeviceHandle addDevice(const Device *device);
+    bool         addLink(const Link &link); // false if an endpoint is unknown
+    void         clear();
+
+    static DeviceStore fromNetwork(const Network *network);
+    void toNetwork(Network *network) const; // replaces the network's contents
+
+    // --- Persistence (same file format as Network) ---
+    bool load(const QString &filePath, QString *error = nullptr);
+    bool save(const QString &filePath, QString *error = nullptr) const;
+    void fromJson(const QJsonObject &root);
+    QJsonObject toJson() const;
+
+    QString name() const              { return m_name; }
+    void    setName(const QString &n) { m_name = n; }
+
+    // --- Devices ---
+    int          deviceCount() const;
+    int          count(Device::Type type) const { return int(m_devices[int(type)].ids.size()); }
+    DeviceHandle find(const QString &id) const  { return m_byId.value(id); }
+
+    QString id(DeviceHandle h)   const { return columns(h).ids[h.index()]; }
+    QString name(DeviceHandle h) const { return columns(h).names[h.index()]; }
+    qreal   x(DeviceHandle h)    const { return columns(h).x[h.index()]; }
+    qreal   y(DeviceHandle h)    const { return columns(h).y[h.index()]; }
+
+    // Interface rows of a device: [firstInterface, firstInterface + interfaceCount)
+    int firstInterface(DeviceHandle h) const { return columns(h).firstInterface[h.index()]; }
+    int interfaceCount(DeviceHandle h) const { return columns(h).interfaceCount[h.index()]; }
+
+    Router::RoutingProtocol routingProtocol(DeviceHandle router) const;
+    QString                 defaultGateway(DeviceHandle pc) const;
+
+    QJsonObject deviceJson(DeviceHandle h) const;
+    Device     *createDevice(DeviceHandle h, QObject *parent = nullptr) const;
+
+    // --- Interfaces (rows shared by every device) ---
+    int          interfaceCount() const           { return int(m_ifaces.names.size()); }
+    DeviceHandle interfaceOwner(int row) const    { return m_ifaces.owner[row]; }
+    QString      interfaceName(int row) const     { return m_ifaces.names[row]; }
+    quint32      interfaceIp(int row) const       { return m_ifaces.ip[row]; }
+    quint32      interfaceMask(int row) const     { return m_ifaces.mask[row]; }
+    bool         interfaceConfigured(int row) const
+    {
+        return (m_ifaces.flags[row] & (HasIp | HasMask)) == (HasIp | HasMask);
+    }
+    int          interfaceLink(int row) const     { return m_ifaces.link[row]; } // -1 if unlinked
+    int          findInterface(DeviceHandle h, const QString &name) const;      // -1 if none
+    NetworkInterface interfaceAt(int row) const;
+
+    // --- Links ---
+    int     linkCount() const      { return int(m_links.ids.size()); }
+    QString linkId(int row) const  { return m_links.ids[row]; }
+    int     linkEnd1(int row) const { return m_links.end1[row]; } // interface rows
+    int     linkEnd2(int row) const { return m_links.end2[row]; }
+    Link    linkAt(int row) const;
+
+    // Device at the far end of the link on an interface row (invalid if none)
+    DeviceHandle neighbor(int interfaceRow) const;
+    QList<DeviceHandle> neighbors(DeviceHandle h) const;
+
+private:
+    enum InterfaceFlag : quint8 { HasIp = 0x1, HasMask = 0x2 };
+
+    struct DeviceColumns {        // one row per device of a type
+        QList<QString> ids;
+        QList<QString> names;
+        QList<qreal>   x, y;
+        QList<int>     firstInterface;
+        QList<quint16> interfaceCount;
+    };
+    struct InterfaceColumns {     // one row per interface, all devices
+        QList<DeviceHandle> owner;
+        QList<QString>      names;
+        QList<quint32>      ip, mask;
+        QList<quint8>       flags;
+        QList<int>          ospfCost;
+        QList<int>          link;
+        QHash<int, QString> descriptions;
+        QHash<int, QPair<IpUtils::Ip6Address, int>> ipv6;
+    };
+    struct RouterColumns {        // parallel to m_devices[Router]
+        QList<quint8>                         protocol;
+        QList<QString>                        ospfRouterId;
+        QList<QString>                        ospfArea;
+        QList<int>                            ospfProcessId;
+        QHash<int, QList<Router::StaticRoute>> staticRoutes;
+        QHash<int, QStringList>               ripNetworks;
+        QHash<int, QStringList>               pimInterfaces;
+    };
+    struct PcColumns {            // parallel to m_devices[PC]
+        QList<QString>          defaultGateway;
+        QHash<int, QStringList> multicastGroups;
+    };
+    struct LinkColumns {
+        QList<QString> ids;
+        QList<int>     end1, end2;
+        QList<int>     bandwidth, delay;
+    };
+
+    const DeviceColumns &columns(DeviceHandle h) const { return m_devices[int(h.type())]; }
+
+    DeviceHandle appendDevice(Device::Type type, const QString &id, const QString &name,
+                              qreal x, qreal y);
+    void         appendInterface(DeviceHandle owner, const NetworkInterface &iface);
+    void         addDeviceJson(const QJsonObject &obj);
+
+    std::array<DeviceColumns, 4> m_devices; // indexed by Device::Type
+    InterfaceColumns             m_ifaces;
+    RouterColumns                m_routers;
+    PcColumns                    m_pcs;
+    LinkColumns                  m_links;
+    QHash<QString, DeviceHandle> m_byId;
+    QString                      m_name = "Untitled Network";
+};
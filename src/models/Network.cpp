@@ -1,9 +1,11 @@
 #include "models/Network.h"
+#include "utils/Trace.h"
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QUuid>
+#include <algorithm>
 
 Network::Network(QObject *parent) : QObject(parent) {}
 
@@ -14,19 +16,36 @@ void Network::addDevice(Device *device)
 {
     device->setParent(this);
     m_devices.insert(device->id(), device);
+    indexDevice(device);
+    emit deviceAdded(device->id());
     emit modified();
 }
 
 void Network::removeDevice(const QString &deviceId)
 {
     // Remove all links referencing this device
-    QStringList toRemove;
-    for (auto it = m_links.begin(); it != m_links.end(); ++it)
-        if (it->device1Id == deviceId || it->device2Id == deviceId)
-            toRemove.append(it->id);
-    for (const auto &id : toRemove) m_links.remove(id);
+    const QStringList toRemove = m_linksByDevice.value(m_pool.find(deviceId));
+    for (const auto &id : toRemove) {
+        emit linkRemoved(id);
+        unindexLink(m_links.take(id));
+    }
 
-    if (Device *d = m_devices.take(deviceId)) delete d;
+    if (m_devices.contains(deviceId)) {
+        emit deviceRemoved(deviceId);
+        Device *d = m_devices.take(deviceId);
+        unindexDevice(d);
+        delete d;
+    }
+    emit modified();
+}
+
+void Network::notifyDeviceChanged(const QString &deviceId)
+{
+    Device *d = m_devices.value(deviceId, nullptr);
+    if (!d) return;
+    unindexAddresses(d);
+    indexAddresses(d);
+    emit deviceChanged(deviceId);
     emit modified();
 }
 
@@ -34,55 +53,194 @@ Device *Network::device(const QString &id) const { return m_devices.value(id, nu
 
 QList<Device *> Network::devices() const { return m_devices.values(); }
 
-QList<Router *> Network::routers() const
+// The type lists are updated here rather than rebuilt on every query; a
+// router moves between protocol lists when its protocol changes.
+void Network::indexDevice(Device *device)
 {
-    QList<Router *> result;
-    for (auto *d : m_devices)
-        if (auto *r = qobject_cast<Router *>(d)) result.append(r);
-    return result;
+    device->internNames(m_pool);
+    indexAddresses(device);
+    connect(device, &Device::addressesChanged, this, [this, device]() {
+        notifyDeviceChanged(device->id());
+    });
+    if (auto *r = qobject_cast<Router *>(device)) {
+        m_routers.append(r);
+        m_routersByProtocol[int(r->routingProtocol())].append(r);
+        connect(r, &Router::protocolChanged, this, [this, r](Router::RoutingProtocol previous) {
+            m_routersByProtocol[int(previous)].removeOne(r);
+            m_routersByProtocol[int(r->routingProtocol())].append(r);
+        });
+    } else if (auto *s = qobject_cast<Switch *>(device)) {
+        m_switches.append(s);
+    } else if (auto *h = qobject_cast<Hub *>(device)) {
+        m_hubs.append(h);
+    } else if (auto *p = qobject_cast<PC *>(device)) {
+        m_pcs.append(p);
+    }
 }
 
-QList<PC *> Network::pcs() const
+void Network::unindexDevice(Device *device)
 {
-    QList<PC *> result;
-    for (auto *d : m_devices)
-        if (auto *p = qobject_cast<PC *>(d)) result.append(p);
-    return result;
+    unindexAddresses(device);
+    disconnect(device, &Device::addressesChanged, this, nullptr);
+    if (auto *r = qobject_cast<Router *>(device)) {
+        disconnect(r, &Router::protocolChanged, this, nullptr);
+        m_routers.removeOne(r);
+        m_routersByProtocol[int(r->routingProtocol())].removeOne(r);
+    } else if (auto *s = qobject_cast<Switch *>(device)) {
+        m_switches.removeOne(s);
+    } else if (auto *h = qobject_cast<Hub *>(device)) {
+        m_hubs.removeOne(h);
+    } else if (auto *p = qobject_cast<PC *>(device)) {
+        m_pcs.removeOne(p);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Address index
+// ---------------------------------------------------------------------------
+void Network::indexAddresses(Device *device)
+{
+    QList<quint32> addresses;
+    const auto &ifaces = device->interfaces();
+    for (int i = 0; i < ifaces.size(); ++i) {
+        if (!ifaces[i].hasIpAddress()) continue;
+        const quint32 address = ifaces[i].ipAsUint32();
+        const InterfaceRef ref{device, i};
+        if (m_addressOwner.contains(address))
+            m_addressConflicts.insert(address, ref);
+        else
+            m_addressOwner.insert(address, ref);
+        addresses.append(address);
+    }
+    if (!addresses.isEmpty())
+        m_indexedAddresses.insert(device, addresses);
+}
+
+// Uses the addresses recorded at indexing time, since the interfaces may
+// have been edited since.  A conflicting owner takes over a freed address.
+void Network::unindexAddresses(Device *device)
+{
+    for (const quint32 address : m_indexedAddresses.take(device)) {
+        for (auto it = m_addressConflicts.find(address);
+             it != m_addressConflicts.end() && it.key() == address; ) {
+            if (it->device == device) it = m_addressConflicts.erase(it);
+            else ++it;
+        }
+
+        auto owner = m_addressOwner.find(address);
+        if (owner == m_addressOwner.end() || owner->device != device) continue;
+        auto next = m_addressConflicts.find(address);
+        if (next != m_addressConflicts.end()) {
+            *owner = next.value();
+            m_addressConflicts.erase(next);
+        } else {
+            m_addressOwner.erase(owner);
+        }
+    }
+}
+
+QList<Network::InterfaceRef> Network::addressOwners(quint32 address) const
+{
+    QList<InterfaceRef> owners;
+    const InterfaceRef primary = addressOwner(address);
+    if (!primary.isValid()) return owners;
+    owners.append(primary);
+    owners.append(m_addressConflicts.values(address));
+    return owners;
+}
+
+QList<quint32> Network::conflictingAddresses() const
+{
+    QList<quint32> addresses = m_addressConflicts.uniqueKeys();
+    std::sort(addresses.begin(), addresses.end());
+    return addresses;
 }
 
 // ---------------------------------------------------------------------------
 // Links
 // ---------------------------------------------------------------------------
+// The link's device ids and interface names share the pooled text, and the
+// ids are kept as symbols so the per-device scans below compare integers.
+Network::LinkEntry Network::makeEntry(const Link &link)
+{
+    LinkEntry entry{link, m_pool.intern(link.device1Id), m_pool.intern(link.device2Id)};
+    entry.link.device1Id  = m_pool.text(entry.device1);
+    entry.link.device2Id  = m_pool.text(entry.device2);
+    entry.link.interface1 = m_pool.pooled(link.interface1);
+    entry.link.interface2 = m_pool.pooled(link.interface2);
+    return entry;
+}
+
+// Each device's link ids are kept sorted as links come and go, so per-device
+// lookups neither scan every link nor sort.
+void Network::indexLink(const LinkEntry &entry)
+{
+    const QString &id = entry.link.id;
+    auto insertSorted = [&id](QStringList &ids) {
+        ids.insert(std::lower_bound(ids.begin(), ids.end(), id), id);
+    };
+    insertSorted(m_linksByDevice[entry.device1]);
+    if (entry.device2 != entry.device1) insertSorted(m_linksByDevice[entry.device2]);
+}
+
+void Network::unindexLink(const LinkEntry &entry)
+{
+    for (const Symbol device : {entry.device1, entry.device2}) {
+        auto it = m_linksByDevice.find(device);
+        if (it == m_linksByDevice.end()) continue;
+        const auto pos = std::lower_bound(it->begin(), it->end(), entry.link.id);
+        if (pos != it->end() && *pos == entry.link.id) it->erase(pos);
+        if (it->isEmpty()) m_linksByDevice.erase(it);
+    }
+}
+
+QList<const Network::LinkEntry *> Network::entriesForDevice(Symbol device) const
+{
+    QList<const LinkEntry *> result;
+    auto ids = m_linksByDevice.constFind(device);
+    if (ids == m_linksByDevice.constEnd()) return result;
+    result.reserve(ids->size());
+    for (const QString &id : *ids) result.append(&m_links.constFind(id).value());
+    return result;
+}
+
 void Network::addLink(const Link &link)
 {
-    m_links.insert(link.id, link);
+    auto existing = m_links.constFind(link.id);
+    if (existing != m_links.constEnd()) unindexLink(existing.value());
+    const LinkEntry entry = makeEntry(link);
+    m_links.insert(link.id, entry);
+    indexLink(entry);
+    emit linkAdded(link.id);
     emit modified();
 }
 
 void Network::removeLink(const QString &linkId)
 {
-    m_links.remove(linkId);
+    if (m_links.contains(linkId)) {
+        emit linkRemoved(linkId);
+        unindexLink(m_links.take(linkId));
+    }
     emit modified();
 }
 
 const Link *Network::link(const QString &id) const
 {
     auto it = m_links.constFind(id);
-    return (it != m_links.constEnd()) ? &it.value() : nullptr;
+    return (it != m_links.constEnd()) ? &it->link : nullptr;
 }
 
 QList<const Link *> Network::links() const
 {
     QList<const Link *> result;
-    for (const auto &l : m_links) result.append(&l);
+    for (const auto &e : m_links) result.append(&e.link);
     return result;
 }
 
 QList<const Link *> Network::linksForDevice(const QString &deviceId) const
 {
     QList<const Link *> result;
-    for (const auto &l : m_links)
-        if (l.device1Id == deviceId || l.device2Id == deviceId) result.append(&l);
+    for (const LinkEntry *e : entriesForDevice(m_pool.find(deviceId))) result.append(&e->link);
     return result;
 }
 
@@ -111,9 +269,10 @@ QString Network::availableInterface(const QString &deviceId) const
     if (!d) return {};
 
     QSet<QString> used;
-    for (const auto &l : m_links) {
-        if (l.device1Id == deviceId) used.insert(l.interface1);
-        if (l.device2Id == deviceId) used.insert(l.interface2);
+    const Symbol dev = d->idSymbol();
+    for (const LinkEntry *e : entriesForDevice(dev)) {
+        if (e->device1 == dev) used.insert(e->link.interface1);
+        if (e->device2 == dev) used.insert(e->link.interface2);
     }
 
     for (const auto &iface : d->interfaces())
@@ -123,9 +282,10 @@ QString Network::availableInterface(const QString &deviceId) const
 
 bool Network::interfaceInUse(const QString &deviceId, const QString &ifaceName) const
 {
-    for (const auto &l : m_links)
-        if ((l.device1Id == deviceId && l.interface1 == ifaceName) ||
-            (l.device2Id == deviceId && l.interface2 == ifaceName))
+    const Symbol dev = m_pool.find(deviceId);
+    for (const LinkEntry *e : entriesForDevice(dev))
+        if ((e->device1 == dev && e->link.interface1 == ifaceName) ||
+            (e->device2 == dev && e->link.interface2 == ifaceName))
             return true;
     return false;
 }
@@ -135,6 +295,7 @@ bool Network::interfaceInUse(const QString &deviceId, const QString &ifaceName)
 // ---------------------------------------------------------------------------
 bool Network::save(const QString &filePath, QString *error) const
 {
+    TRACE_SCOPE("Network::save");
     QJsonObject root;
     root["name"] = m_name;
 
@@ -143,7 +304,7 @@ bool Network::save(const QString &filePath, QString *error) const
     root["devices"] = devArray;
 
     QJsonArray linkArray;
-    for (const auto &l : m_links) linkArray.append(l.toJson());
+    for (const auto &e : m_links) linkArray.append(e.link.toJson());
     root["links"] = linkArray;
 
     QFile file(filePath);
@@ -157,6 +318,7 @@ bool Network::save(const QString &filePath, QString *error) const
 
 bool Network::load(const QString &filePath, QString *error)
 {
+    TRACE_SCOPE("Network::load");
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         if (error) *error = file.errorString();
@@ -170,11 +332,9 @@ bool Network::load(const QString &filePath, QString *error)
         return false;
     }
 
-    clear();
-
     const QJsonObject root = doc.object();
-    m_name = root["name"].toString("Untitled Network");
 
+    QList<Device *> devices;
     for (const auto &v : root["devices"].toArray()) {
         const QJsonObject dObj = v.toObject();
         const QString type = dObj["type"].toString();
@@ -183,23 +343,61 @@ bool Network::load(const QString &filePath, QString *error)
         else if (type == "Switch") d = Switch::fromJson(dObj, this);
         else if (type == "Hub")    d = Hub::fromJson(dObj, this);
         else if (type == "PC")     d = PC::fromJson(dObj, this);
-        if (d) m_devices.insert(d->id(), d);
+        if (d) devices.append(d);
     }
 
-    for (const auto &v : root["links"].toArray()) {
-        const Link l = Link::fromJson(v.toObject());
-        m_links.insert(l.id, l);
+    QList<Link> links;
+    for (const auto &v : root["links"].toArray())
+        links.append(Link::fromJson(v.toObject()));
+
+    assign(root["name"].toString("Untitled Network"), devices, links);
+    return true;
+}
+
+void Network::assign(const QString &name, const QList<Device *> &devices, const QList<Link> &links)
+{
+    clearContents();
+    m_name = name;
+    m_devices.reserve(devices.size());
+    for (Device *d : devices) {
+        d->setParent(this);
+        m_devices.insert(d->id(), d);
+        indexDevice(d);
+    }
+    m_links.reserve(links.size());
+    for (const Link &l : links) {
+        const LinkEntry entry = makeEntry(l);
+        m_links.insert(l.id, entry);
+        indexLink(entry);
     }
 
+    emit reset();
     emit modified();
-    return true;
 }
 
 void Network::clear()
+{
+    clearContents();
+    emit reset();
+    emit modified();
+}
+
+// Drops every device and link without notifying, so load() can swap the
+// contents and report a single reset().
+void Network::clearContents()
 {
     qDeleteAll(m_devices);
     m_devices.clear();
+    m_routers.clear();
+    for (auto &list : m_routersByProtocol) list.clear();
+    m_switches.clear();
+    m_hubs.clear();
+    m_pcs.clear();
+    m_addressOwner.clear();
+    m_addressConflicts.clear();
+    m_indexedAddresses.clear();
     m_links.clear();
+    m_linksByDevice.clear();
+    m_pool.clear();
     m_name = "Untitled Network";
-    emit modified();
 }
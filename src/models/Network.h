@@ -2,8 +2,10 @@
 #include <QObject>
 #include <QHash>
 #include <QList>
+#include <array>
 #include "models/Device.h"
 #include "models/Link.h"
+#include "utils/StringPool.h"
 
 class Network : public QObject
 {
@@ -14,17 +16,43 @@ public:
     // --- Devices ---
     void    addDevice(Device *device);
     void    removeDevice(const QString &deviceId);
+    void    notifyDeviceChanged(const QString &deviceId); // after editing a device in place
     Device *device(const QString &id) const;
     QList<Device *> devices() const;
-    QList<Router *> routers() const;
-    QList<PC *>     pcs()     const;
+
+    // Per-type lists in insertion order, maintained on add and remove
+    const QList<Router *> &routers()  const { return m_routers; }
+    const QList<Router *> &routers(Router::RoutingProtocol protocol) const
+    {
+        return m_routersByProtocol[int(protocol)];
+    }
+    const QList<Switch *> &switches() const { return m_switches; }
+    const QList<Hub *>    &hubs()     const { return m_hubs; }
+    const QList<PC *>     &pcs()      const { return m_pcs; }
+
+    // --- Address index ---
+    // IPv4 address -> owning interface.  Kept current on add, remove and load,
+    // on Device::setInterfaceAddress(), and by notifyDeviceChanged(), which
+    // edits made directly through Device::interfaces() must call.
+    // When several interfaces share an address, the first one indexed is the
+    // primary owner and the rest are recorded as conflicts.
+    struct InterfaceRef {
+        Device *device = nullptr;
+        int     index  = -1; // into device->interfaces()
+
+        bool isValid() const { return device != nullptr; }
+        const NetworkInterface &iface() const { return device->interfaces()[index]; }
+    };
+    InterfaceRef        addressOwner(quint32 address) const { return m_addressOwner.value(address); }
+    QList<InterfaceRef> addressOwners(quint32 address) const; // primary first
+    QList<quint32>      conflictingAddresses() const;         // ascending
 
     // --- Links ---
     void    addLink(const Link &link);
     void    removeLink(const QString &linkId);
     const Link *link(const QString &id) const;
     QList<const Link *> links() const;
-    QList<const Link *> linksForDevice(const QString &deviceId) const;
+    QList<const Link *> linksForDevice(const QString &deviceId) const; // ordered by link id
 
     // --- Topology helpers ---
     Device *neighbor(const Link *link, const QString &deviceId) const;
@@ -37,14 +65,55 @@ public:
     bool load(const QString &filePath, QString *error = nullptr);
     void clear();
 
+    // Replaces the contents in one step (takes ownership of the devices) and
+    // reports a single reset(), like load()
+    void assign(const QString &name, const QList<Device *> &devices, const QList<Link> &links);
+
     QString name() const        { return m_name; }
     void    setName(const QString &n) { m_name = n; }
 
 signals:
     void modified();
 
+    // Typed change events, so views can update only what changed.  Removal
+    // signals fire while the object is still present; a device's links are
+    // reported removed before the device itself.  reset() follows clear()
+    // and load(), after which listeners should re-sync by id.
+    void deviceAdded(const QString &deviceId);
+    void deviceRemoved(const QString &deviceId);
+    void deviceChanged(const QString &deviceId);
+    void linkAdded(const QString &linkId);
+    void linkRemoved(const QString &linkId);
+    void reset();
+
 private:
+    struct LinkEntry {
+        Link   link;
+        Symbol device1; // link.device1Id in m_pool
+        Symbol device2;
+    };
+    LinkEntry makeEntry(const Link &link);
+    void indexLink(const LinkEntry &entry);
+    void unindexLink(const LinkEntry &entry);
+    QList<const LinkEntry *> entriesForDevice(Symbol device) const;
+
+    void clearContents();
+    void indexDevice(Device *device);
+    void unindexDevice(Device *device);
+    void indexAddresses(Device *device);
+    void unindexAddresses(Device *device);
+
     QHash<QString, Device *> m_devices; // owns devices (parent = this)
-    QHash<QString, Link>     m_links;
+    QList<Router *>          m_routers;
+    std::array<QList<Router *>, 4> m_routersByProtocol; // by Router::RoutingProtocol
+    QList<Switch *>          m_switches;
+    QList<Hub *>             m_hubs;
+    QList<PC *>              m_pcs;
+    QHash<quint32, InterfaceRef>             m_addressOwner;
+    QMultiHash<quint32, InterfaceRef>        m_addressConflicts; // owners after the first
+    QHash<const Device *, QList<quint32>>    m_indexedAddresses; // to unindex after edits
+    StringPool               m_pool;  // device ids and interface names; emptied with the contents
+    QHash<QString, LinkEntry> m_links;
+    QHash<Symbol, QStringList> m_linksByDevice; // device -> its link ids, sorted
     QString                  m_name = "Untitled Network";
 };
@@ -1,38 +1,70 @@
 #include "routing/OSPF.h"
+#include "routing/SimulationStats.h"
 #include "models/Network.h"
+#include "utils/Trace.h"
 #include "utils/IpUtils.h"
-#include <QHash>
-#include <QSet>
+#include "utils/ScratchArena.h"
+#include <algorithm>
 #include <climits>
+#include <functional>
+#include <utility>
 
 // ---------------------------------------------------------------------------
 // Internal edge structure used by Dijkstra
 // ---------------------------------------------------------------------------
 struct OspfEdge {
-    QString neighborId;
+    int     neighbor;         // index into the protocol's router list
     int     cost;
+    QString linkId;
     QString localInterface;   // on the source router
-    QString neighborInterface;// on the neighbor router
     QString neighborIp;       // IP of the neighbor's interface (used as next-hop)
+    QString neighborIp6;      // its IPv6 address, if any (IPv6 next-hop)
 };
 
-void OSPF::compute(Network *network)
+// A network a router advertises: formatted once per run, installed by every
+// root that reaches the router
+struct OspfPrefix {
+    QString destination;
+    QString mask;
+    QString interfaceName;
+    bool    ipv6;
+};
+
+// (destination, mask) of a row already in the root's table
+using RouteKey = std::pair<QString, QString>;
+struct RouteKeyHash {
+    std::size_t operator()(const RouteKey &k) const { return qHash(k.first, qHash(k.second)); }
+};
+
+void OSPF::compute(Network *network, SimulationStats *stats)
+{
+    computeFor(network, Router::RoutingProtocol::OSPF, "OSPF", stats, "OSPFv3");
+}
+
+void OSPF::computeFor(Network *network, Router::RoutingProtocol protocol, const QString &label,
+                      SimulationStats *stats, const QString &ipv6Label,
+                      const QSet<QString> *roots, SpfTrees *trees)
 {
+    TRACE_SCOPE("OSPF::computeFor");
     // -----------------------------------------------------------------------
-    // Build adjacency list for OSPF routers
+    // Build adjacency list for OSPF routers.  All scratch state is indexed by
+    // position in ospfRouters and lives in one arena released on return.
     // -----------------------------------------------------------------------
-    QList<Router *> ospfRouters;
-    for (auto *r : network->routers())
-        if (r->routingProtocol() == Router::RoutingProtocol::OSPF)
-            ospfRouters.append(r);
+    const QList<Router *> &ospfRouters = network->routers(protocol);
+    const int n = static_cast<int>(ospfRouters.size());
+
+    ScratchArena arena;
+    ScratchArena::Hash<const Router *, int> indexOf(arena.resource());
+    for (int i = 0; i < n; ++i) indexOf.emplace(ospfRouters[i], i);
 
-    QHash<QString, QList<OspfEdge>> adjacency; // routerId -> edges
+    ScratchArena::Vector<ScratchArena::Vector<OspfEdge>>   adjacency(n, arena.resource());
+    ScratchArena::Vector<ScratchArena::Vector<OspfPrefix>> prefixes(n, arena.resource());
 
-    for (auto *router : ospfRouters) {
-        adjacency[router->id()] = {};
+    for (int i = 0; i < n; ++i) {
+        Router *router = ospfRouters[i];
         for (const Link *link : network->linksForDevice(router->id())) {
             Router *nbr = qobject_cast<Router *>(network->neighbor(link, router->id()));
-            if (!nbr || nbr->routingProtocol() != Router::RoutingProtocol::OSPF) continue;
+            if (!nbr || nbr->routingProtocol() != protocol) continue;
 
             const QString localIface = network->interfaceForLink(link, router->id());
             const QString nbrIface   = network->interfaceForLink(link, nbr->id());
@@ -41,96 +73,123 @@ void OSPF::compute(Network *network)
             if (const NetworkInterface *iface = router->getInterface(localIface))
                 cost = iface->ospfCost;
 
-            QString nbrIp;
-            if (const NetworkInterface *iface = nbr->getInterface(nbrIface))
-                nbrIp = iface->ipAddress;
+            QString nbrIp, nbrIp6;
+            if (const NetworkInterface *iface = nbr->getInterface(nbrIface)) {
+                nbrIp = iface->ipAddress();
+                if (iface->hasIpv6()) nbrIp6 = IpUtils::format6(iface->ipv6());
+            }
 
-            adjacency[router->id()].append({nbr->id(), cost, localIface, nbrIface, nbrIp});
+            adjacency[i].push_back({indexOf.at(nbr), cost, link->id, localIface, nbrIp, nbrIp6});
         }
+
+        // IPv4 networks first, then IPv6, as they are installed
+        for (const auto &iface : router->interfaces())
+            if (iface.isConfigured())
+                prefixes[i].push_back({IpUtils::format(iface.networkAddr()), iface.subnetMask(),
+                                       iface.name, false});
+        for (const auto &iface : router->interfaces())
+            if (!ipv6Label.isEmpty() && iface.hasIpv6())
+                prefixes[i].push_back({IpUtils::format6(iface.ipv6Network()),
+                                       QString("/%1").arg(iface.ipv6PrefixLen()), iface.name, true});
     }
 
+    // Per-root state, allocated once and reset for every root
+    ScratchArena::Vector<int>  dist(n, arena.resource());     // total cost from the root
+    ScratchArena::Vector<int>  firstHop(n, arena.resource()); // root edge the path leaves on
+    ScratchArena::Vector<const OspfEdge *> parent(n, arena.resource()); // tree edge into each router
+    ScratchArena::Vector<char> visited(n, arena.resource());
+    ScratchArena::Vector<std::pair<int, int>> heap(arena.resource()); // (dist, router), lazy deletion
+    ScratchArena::Set<RouteKey, RouteKeyHash> installed(arena.resource());
+
     // -----------------------------------------------------------------------
     // Run Dijkstra from every OSPF router
     // -----------------------------------------------------------------------
-    for (auto *root : ospfRouters) {
+    for (int rootIndex = 0; rootIndex < n; ++rootIndex) {
+        Router *root = ospfRouters[rootIndex];
+        if (roots && !roots->contains(root->id())) continue;
+        TRACE_SCOPE("OSPF::spf");
         root->clearRoutingTable();
+        installed.clear();
+        if (stats) ++stats->spfRuns;
 
         // Add directly-connected networks
-        for (const auto &iface : root->interfaces()) {
-            if (!iface.isConfigured()) continue;
+        for (const OspfPrefix &p : prefixes[rootIndex]) {
             RoutingEntry e;
-            e.destination  = IpUtils::format(iface.networkAddr());
-            e.mask         = iface.subnetMask;
-            e.nextHop      = "directly connected";
-            e.exitInterface = iface.name;
+            e.destination  = p.destination;
+            e.mask         = p.mask;
+            e.nextHop      = QStringLiteral("directly connected");
+            e.exitInterface = p.interfaceName;
             e.metric       = 0;
-            e.protocol     = "Connected";
+            e.protocol     = QStringLiteral("Connected");
             root->addRoutingEntry(e);
+            installed.insert({p.destination, p.mask});
         }
 
-        // dist[id] = total cost from root to that router
-        QHash<QString, int>     dist;
-        QHash<QString, QString> firstHopIp;    // next-hop IP toward this router
-        QHash<QString, QString> firstHopIface; // exit interface toward this router
-
-        for (auto *r : ospfRouters)
-            dist[r->id()] = (r->id() == root->id()) ? 0 : INT_MAX;
-
-        QSet<QString> visited;
-
-        while (visited.size() < static_cast<int>(ospfRouters.size())) {
-            // Pick unvisited node with minimum distance
-            QString u;
-            int minDist = INT_MAX;
-            for (auto *r : ospfRouters) {
-                if (!visited.contains(r->id()) && dist[r->id()] < minDist) {
-                    minDist = dist[r->id()];
-                    u = r->id();
-                }
-            }
-            if (u.isEmpty() || minDist == INT_MAX) break;
-            visited.insert(u);
-
-            for (const OspfEdge &edge : adjacency[u]) {
-                int newDist = dist[u] + edge.cost;
-                if (newDist < dist[edge.neighborId]) {
-                    dist[edge.neighborId] = newDist;
-                    if (u == root->id()) {
-                        // Direct neighbor of root
-                        firstHopIp[edge.neighborId]    = edge.neighborIp;
-                        firstHopIface[edge.neighborId] = edge.localInterface;
-                    } else {
-                        // Inherit first-hop from the parent
-                        firstHopIp[edge.neighborId]    = firstHopIp.value(u);
-                        firstHopIface[edge.neighborId] = firstHopIface.value(u);
-                    }
+        std::fill(dist.begin(), dist.end(), INT_MAX);
+        std::fill(firstHop.begin(), firstHop.end(), -1);
+        std::fill(parent.begin(), parent.end(), nullptr);
+        std::fill(visited.begin(), visited.end(), 0);
+        dist[rootIndex] = 0;
+
+        const ScratchArena::Vector<OspfEdge> &rootEdges = adjacency[rootIndex];
+
+        // Routers leave the heap by (distance, position in ospfRouters), the
+        // same order as a linear scan for the first closest router, so equal-
+        // cost paths resolve identically
+        heap.clear();
+        heap.push_back({0, rootIndex});
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+            const auto [d, u] = heap.back();
+            heap.pop_back();
+            if (visited[u] || d != dist[u]) continue; // superseded entry
+            visited[u] = 1;
+            if (stats) ++stats->heapOps; // extract-min
+
+            const ScratchArena::Vector<OspfEdge> &edges = adjacency[u];
+            for (int k = 0; k < static_cast<int>(edges.size()); ++k) {
+                const OspfEdge &edge = edges[k];
+                const int newDist = dist[u] + edge.cost;
+                if (newDist < dist[edge.neighbor]) {
+                    dist[edge.neighbor] = newDist;
+                    parent[edge.neighbor] = &edge;
+                    heap.push_back({newDist, edge.neighbor});
+                    std::push_heap(heap.begin(), heap.end(), std::greater<>());
+                    if (stats) ++stats->heapOps; // decrease-key
+                    // Direct neighbors of the root leave on this edge; the
+                    // rest inherit the first hop from their parent
+                    firstHop[edge.neighbor] = (u == rootIndex) ? k : firstHop[u];
                 }
             }
         }
 
-        // Add routes to every reachable OSPF router's networks
-        for (auto *other : ospfRouters) {
-            if (other->id() == root->id()) continue;
-            if (dist[other->id()] == INT_MAX) continue;
+        if (trees)
+            for (int v = 0; v < n; ++v)
+                if (parent[v] && dist[v] != INT_MAX)
+                    trees->rootsByLink[parent[v]->linkId].append(root->id());
 
-            for (const auto &iface : other->interfaces()) {
-                if (!iface.isConfigured()) continue;
-                const QString dest = IpUtils::format(iface.networkAddr());
+        // Add routes to every reachable OSPF router's networks
+        for (int o = 0; o < n; ++o) {
+            if (o == rootIndex || dist[o] == INT_MAX) continue;
+            const OspfEdge *hop = firstHop[o] >= 0 ? &rootEdges[firstHop[o]] : nullptr;
 
+            for (const OspfPrefix &p : prefixes[o]) {
                 // Don't duplicate an entry already in the table
-                bool exists = false;
-                for (const auto &existing : root->computedRoutingTable())
-                    if (existing.destination == dest && existing.mask == iface.subnetMask)
-                        { exists = true; break; }
-                if (exists) continue;
+                if (!installed.insert({p.destination, p.mask}).second) continue;
 
                 RoutingEntry e;
-                e.destination  = dest;
-                e.mask         = iface.subnetMask;
-                e.nextHop      = firstHopIp.value(other->id(), "unknown");
-                e.exitInterface = firstHopIface.value(other->id(), "unknown");
-                e.metric       = dist[other->id()];
-                e.protocol     = "OSPF";
+                e.destination = p.destination;
+                e.mask        = p.mask;
+                if (p.ipv6) {
+                    const QString nextHop = hop ? hop->neighborIp6 : QString();
+                    e.nextHop  = nextHop.isEmpty() ? QStringLiteral("unknown") : nextHop;
+                    e.protocol = ipv6Label;
+                } else {
+                    e.nextHop  = hop ? hop->neighborIp : QStringLiteral("unknown");
+                    e.protocol = label;
+                }
+                e.exitInterface = hop ? hop->localInterface : QStringLiteral("unknown");
+                e.metric       = dist[o];
                 root->addRoutingEntry(e);
             }
         }
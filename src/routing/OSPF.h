@@ -1,10 +1,39 @@
 #pragma once
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include "models/Device.h"
+
 class Network;
+struct SimulationStats;
 
 class OSPF
 {
 public:
+    // The links each root's shortest-path tree uses, as root router ids per
+    // link id.  A root whose tree avoids a link keeps the same tree when that
+    // link fails or its cost rises, so what-if runs can skip its SPF.
+    struct SpfTrees {
+        QHash<QString /*linkId*/, QStringList /*rootIds*/> rootsByLink;
+    };
+
     // Populates computedRoutingTable on every OSPF router in the network
-    // using Dijkstra's SPF algorithm.
-    static void compute(Network *network);
+    // using Dijkstra's SPF algorithm.  Adds SPF runs and heap operations to
+    // 'stats' when given.
+    static void compute(Network *network, SimulationStats *stats = nullptr);
+
+    // Same SPF over the routers running 'protocol', labelling learned routes
+    // with 'label'.  Gives PIM-DM routers the unicast routes their RPF checks
+    // need.  With a non-empty 'ipv6Label' the same shortest-path trees also
+    // install the IPv6 prefixes (OSPFv3 style: one topology, both families).
+    // With 'roots', only those routers (by id) recompute their tables; the
+    // rest keep theirs.  With 'trees', the links of each tree are recorded.
+    static void computeFor(Network *network,
+                           Router::RoutingProtocol protocol,
+                           const QString &label,
+                           SimulationStats *stats = nullptr,
+                           const QString &ipv6Label = QString(),
+                           const QSet<QString> *roots = nullptr,
+                           SpfTrees *trees = nullptr);
 };
@@ -1,194 +1,368 @@
 #include "routing/PIMDenseMode.h"
 #include "models/Network.h"
 #include "utils/IpUtils.h"
+#include "utils/PrefixTrie.h"
+#include "utils/ScratchArena.h"
+#include "utils/Trace.h"
 #include <QHash>
-#include <QQueue>
-#include <climits>
+#include <QtConcurrentMap>
 
 // ---------------------------------------------------------------------------
 // Build a shortest-path tree (SPT) from 'sourceIp' across all PIM-DM routers
-// using a simple BFS weighted by hop count. This represents the initial flood.
-// Then prune branches that lead only to routers with no active receivers
-// (for simplicity: routers with no PCs connected downstream are pruned).
+// from the RPF interface each router selects in its unicast routing table.
+// This represents the initial flood.  Then prune branches that lead only to
+// routers with no active receivers, deciding every (router, interface) once
+// in a bottom-up pass over the tree.
 // ---------------------------------------------------------------------------
 
-// Returns the router whose interface owns the given IP, or nullptr.
-static Router *routerOwningIp(const QString &ip, Network *network)
-{
-    for (auto *r : network->routers())
-        for (const auto &iface : r->interfaces())
-            if (iface.ipAddress == ip) return r;
-    return nullptr;
-}
-
 // Determine the first-hop PIM-DM router reachable from sourceIp.
-static Router *findFirstHopRouter(const QString &sourceIp, Network *network)
+static Router *findFirstHopRouter(const QString &sourceIp, Network *network, ScratchArena &arena)
 {
+    IpUtils::ParseError error;
+    const quint32 addr = IpUtils::parse(sourceIp, &error);
+    if (error != IpUtils::ParseError::None) return nullptr;
+    const QList<Network::InterfaceRef> owners = network->addressOwners(addr);
+
     // Check if a router owns this IP directly
-    if (Router *r = routerOwningIp(sourceIp, network))
-        return r;
+    for (const auto &ref : owners)
+        if (Router *r = qobject_cast<Router *>(ref.device))
+            return r;
 
     // Look for a PC with this IP and find a router connected via switch/hub/direct link
     PC *srcPc = nullptr;
-    for (auto *pc : network->pcs())
-        if (pc->ipAddress() == sourceIp) { srcPc = pc; break; }
+    for (const auto &ref : owners)
+        if ((srcPc = qobject_cast<PC *>(ref.device))) break;
     if (!srcPc) return nullptr;
 
     // Walk links from the PC toward a router (may pass through switch/hub)
-    QSet<QString> visited;
-    QQueue<QString> queue;
-    queue.enqueue(srcPc->id());
+    ScratchArena::Set<const Device *>    visited(arena.resource());
+    ScratchArena::Vector<const Device *> queue(arena.resource());
+    queue.push_back(srcPc);
 
-    while (!queue.isEmpty()) {
-        const QString current = queue.dequeue();
-        if (visited.contains(current)) continue;
-        visited.insert(current);
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        const Device *current = queue[head];
+        if (!visited.insert(current).second) continue;
 
-        for (const Link *link : network->linksForDevice(current)) {
-            Device *nbr = network->neighbor(link, current);
+        for (const Link *link : network->linksForDevice(current->id())) {
+            Device *nbr = network->neighbor(link, current->id());
             if (!nbr) continue;
             if (Router *r = qobject_cast<Router *>(nbr))
                 return r;
-            queue.enqueue(nbr->id());
+            queue.push_back(nbr);
         }
     }
     return nullptr;
 }
 
-// Returns true if the sub-tree rooted at 'routerId' (excluding 'parentId')
-// has any PC connected (even through switches/hubs).
-static bool hasPcDownstream(const QString &routerId,
-                             const QString &parentId,
-                             Network *network,
-                             QSet<QString> &visited)
+// A PC counts as a receiver if it joined 'group' (or if no memberships are
+// configured at all, which keeps the single-flow behaviour: any PC listens).
+static bool isReceiver(const Device *pc, const QString &group, const GroupMemberships &memberships)
 {
-    if (visited.contains(routerId)) return false;
-    visited.insert(routerId);
+    return memberships.isEmpty() || memberships.value(pc->id()).contains(group);
+}
+
+// ---------------------------------------------------------------------------
+// Ports: what each router sees out of each linked interface.  Built once per
+// batch and only read afterwards, so concurrent sources share it.
+// ---------------------------------------------------------------------------
+struct PimPort {
+    QString                         iface;     // local interface name
+    QList<QPair<Router *, QString>> routers;   // routers on the far side, with their interface
+    QList<const Device *>           pcs;       // PCs reached without crossing a router
+    bool                            viaLayer2 = false; // port faces a switch/hub segment
+};
+
+// RPF resolution of one routing-table row: the interface a packet from a
+// source matching that row must arrive on, and the upstream router.
+struct RpfHop {
+    QString inIface;
+    Router *upstream  = nullptr;
+    bool    connected = false; // source is on a directly connected subnet
+};
 
-    for (const Link *link : network->linksForDevice(routerId)) {
-        Device *nbr = network->neighbor(link, routerId);
-        if (!nbr || nbr->id() == parentId) continue;
+struct PimRouter {
+    Router        *router = nullptr;
+    QList<PimPort> ports;
+    QList<RpfHop>  rpf;  // per computedRoutingTable() row; the per-prefix RPF cache
+    PrefixTrie     lpm;  // IPv4 unicast prefixes -> table row
+};
 
-        if (qobject_cast<PC *>(nbr)) return true;
+using PimTopology = QHash<QString /*routerId*/, PimRouter>;
 
-        // Switch or Hub – keep searching
-        if (qobject_cast<Switch *>(nbr) || qobject_cast<Hub *>(nbr)) {
-            if (hasPcDownstream(nbr->id(), routerId, network, visited)) return true;
+// The visited set and queue are the caller's, cleared here, so every port
+// of a topology build reuses the same scratch blocks.
+static void collectSegment(const Device *l2, const Device *from, Network *network, PimPort &port,
+                           ScratchArena::Set<const Device *> &visited,
+                           ScratchArena::Vector<const Device *> &queue)
+{
+    visited.clear();
+    visited.insert(from);
+    queue.clear();
+    queue.push_back(l2);
+
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        const Device *current = queue[head];
+        if (!visited.insert(current).second) continue;
+
+        for (const Link *link : network->linksForDevice(current->id())) {
+            Device *nbr = network->neighbor(link, current->id());
+            if (!nbr || visited.count(nbr)) continue;
+            if (qobject_cast<PC *>(nbr))
+                port.pcs.append(nbr);
+            else if (Router *r = qobject_cast<Router *>(nbr))
+                port.routers.append({r, network->interfaceForLink(link, r->id())});
+            else
+                queue.push_back(nbr);
         }
+    }
+}
 
-        // Another PIM-DM router
-        if (Router *r = qobject_cast<Router *>(nbr)) {
-            if (r->routingProtocol() == Router::RoutingProtocol::PIM_DM) {
-                if (hasPcDownstream(r->id(), routerId, network, visited)) return true;
+static RpfHop resolveRpf(const Router *router, const RoutingEntry &e, const QList<PimPort> &ports)
+{
+    RpfHop hop;
+    hop.inIface = e.exitInterface;
+    if (e.nextHop == "directly connected") {
+        hop.connected = true;
+        return hop;
+    }
+    const quint32 nextHop = IpUtils::parse(e.nextHop);
+    for (const PimPort &port : ports) {
+        if (port.iface != e.exitInterface) continue;
+        for (const auto &nbr : port.routers) {
+            const NetworkInterface *iface = nbr.first->getInterface(nbr.second);
+            if (iface && iface->hasIpAddress() && iface->ipAsUint32() == nextHop &&
+                nbr.first != router)
+                hop.upstream = nbr.first;
+        }
+    }
+    return hop;
+}
+
+static PimTopology buildTopology(Network *network)
+{
+    PimTopology topo;
+    ScratchArena arena;
+    ScratchArena::Set<const Device *>    visited(arena.resource());
+    ScratchArena::Vector<const Device *> queue(arena.resource());
+    for (auto *r : network->routers()) {
+        PimRouter &info = topo[r->id()];
+        info.router = r;
+
+        for (const Link *link : network->linksForDevice(r->id())) {
+            Device *nbr = network->neighbor(link, r->id());
+            if (!nbr) continue;
+
+            PimPort port;
+            port.iface = network->interfaceForLink(link, r->id());
+            if (Router *nbrRouter = qobject_cast<Router *>(nbr)) {
+                port.routers.append({nbrRouter, network->interfaceForLink(link, nbr->id())});
+            } else if (qobject_cast<PC *>(nbr)) {
+                port.pcs.append(nbr);
+            } else {
+                port.viaLayer2 = true;
+                collectSegment(nbr, r, network, port, visited, queue);
             }
+            info.ports.append(port);
+        }
+
+        const QList<RoutingEntry> &table = r->computedRoutingTable();
+        for (int i = 0; i < table.size(); ++i) {
+            info.rpf.append(resolveRpf(r, table[i], info.ports));
+            if (table[i].isIpv6()) continue;
+            info.lpm.insert4(IpUtils::parse(table[i].destination),
+                             IpUtils::maskToPrefix(IpUtils::parse(table[i].mask)), i);
         }
     }
-    return false;
+    return topo;
 }
 
-MulticastTree PIMDenseMode::compute(Network *network,
-                                    const QString &sourceIp,
-                                    const QString &groupAddr)
+// Longest-prefix match toward 'address' in the router's unicast table.
+static const RpfHop *rpfLookup(const PimRouter &info, quint32 address)
+{
+    const int row = info.lpm.lookup4(address);
+    return row >= 0 ? &info.rpf[row] : nullptr;
+}
+
+static bool isPimRouter(const Router *r)
+{
+    return r->routingProtocol() == Router::RoutingProtocol::PIM_DM;
+}
+
+// ---------------------------------------------------------------------------
+// Flood: every PIM-DM router accepts the source's traffic only on its RPF
+// interface, found by longest-prefix match toward the source in its unicast
+// table.  Following RPF upstream links from the first-hop router yields the
+// tree.  It depends on the source alone, so all of its groups share it.
+// ---------------------------------------------------------------------------
+struct FloodNode {
+    Router *router;
+    int     parent;   // index into SourceFlood::nodes, -1 for a root
+    QString inIface;  // RPF interface; empty on the first-hop router
+};
+
+struct SourceFlood {
+    explicit SourceFlood(ScratchArena &arena) : nodes(arena.resource()) {}
+
+    ScratchArena::Vector<FloodNode> nodes; // parents before children; nodes[0] is the first-hop router
+};
+
+static SourceFlood floodFrom(const QString &sourceIp, const PimTopology &topo, Network *network,
+                             ScratchArena &arena)
+{
+    SourceFlood flood(arena);
+    Router *firstHop = findFirstHopRouter(sourceIp, network, arena);
+    if (!firstHop) return flood;
+
+    using Child = std::pair<Router *, QString>; // (router, RPF iface)
+    const quint32 source = IpUtils::parse(sourceIp);
+    ScratchArena::Hash<const Router *, ScratchArena::Vector<Child>> children(arena.resource()); // by upstream
+    ScratchArena::Vector<Child> roots(arena.resource()); // PIM-DM routers sharing the source's subnet
+
+    // In network order, not the topology hash's, so trees come out the same
+    // on every run
+    for (Router *r : network->routers()) {
+        if (r == firstHop || !isPimRouter(r)) continue;
+        auto found = topo.constFind(r->id());
+        if (found == topo.constEnd()) continue;
+        const PimRouter &info = found.value();
+        const RpfHop *hop = rpfLookup(info, source);
+        if (!hop) continue;
+        if (hop->connected)
+            roots.emplace_back(info.router, hop->inIface);
+        else if (hop->upstream && (hop->upstream == firstHop || isPimRouter(hop->upstream)))
+            children[hop->upstream].emplace_back(info.router, hop->inIface);
+    }
+
+    flood.nodes.push_back({firstHop, -1, QString()});
+    for (const auto &root : roots)
+        flood.nodes.push_back({root.first, -1, root.second});
+
+    for (int i = 0; i < static_cast<int>(flood.nodes.size()); ++i) {
+        auto it = children.find(flood.nodes[i].router);
+        if (it == children.end()) continue;
+        for (const Child &child : it->second)
+            flood.nodes.push_back({child.first, i, child.second});
+    }
+    return flood;
+}
+
+// ---------------------------------------------------------------------------
+// Prune: one reverse-BFS pass computes "has receivers downstream" for every
+// node from its ports and its children, so each (router, interface) is
+// examined exactly once per group.
+// ---------------------------------------------------------------------------
+static MulticastTree pruneFlood(const SourceFlood &flood,
+                                const PimTopology &topo,
+                                const QString &sourceIp,
+                                const QString &groupAddr,
+                                const GroupMemberships &memberships,
+                                ScratchArena &arena)
 {
     MulticastTree tree;
     tree.sourceIp    = sourceIp;
     tree.groupAddress = groupAddr;
 
-    Router *firstHop = findFirstHopRouter(sourceIp, network);
-    if (!firstHop) return tree;
+    const int n = static_cast<int>(flood.nodes.size());
+    if (n == 0) return tree;
 
-    // -----------------------------------------------------------------------
-    // BFS flood from firstHop across PIM-DM routers only
-    // -----------------------------------------------------------------------
-    struct BfsNode {
-        QString routerId;
-        QString parentId;
-        QString inIface;     // interface used to receive multicast on this router
-    };
+    ScratchArena::Hash<const Router *, int> indexOf(arena.resource());
+    for (int i = 0; i < n; ++i) indexOf.emplace(flood.nodes[i].router, i);
 
-    QQueue<BfsNode> queue;
-    QSet<QString>   visited;
-    queue.enqueue({firstHop->id(), QString(), QString()});
+    ScratchArena::Vector<char>        downstream(n, 0, arena.resource());
+    ScratchArena::Vector<QStringList> oil(n, arena.resource());
 
-    QList<BfsNode> flood; // order of flooding
+    for (int i = n - 1; i >= 0; --i) {
+        const FloodNode &node = flood.nodes[i];
+        bool receivers = false;
 
-    while (!queue.isEmpty()) {
-        BfsNode node = queue.dequeue();
-        if (visited.contains(node.routerId)) continue;
-        visited.insert(node.routerId);
-        flood.append(node);
+        for (const PimPort &port : topo.value(node.router->id()).ports) {
+            // Traffic arrives on the RPF interface and is never sent back out
+            // of it; receivers on that segment are served from upstream
+            if (i != 0 && port.iface == node.inIface) continue;
 
-        Router *r = qobject_cast<Router *>(network->device(node.routerId));
-        if (!r) continue;
+            // Tree children whose RPF interface faces this port
+            bool childWants = false;
+            for (const auto &nbr : port.routers) {
+                const auto found = indexOf.find(nbr.first);
+                const int child = found != indexOf.end() ? found->second : -1;
+                if (child >= 0 && flood.nodes[child].parent == i &&
+                    flood.nodes[child].inIface == nbr.second && downstream[child])
+                    childWants = true;
+            }
 
-        for (const Link *link : network->linksForDevice(node.routerId)) {
-            Device *nbr = network->neighbor(link, node.routerId);
-            Router *nbrRouter = qobject_cast<Router *>(nbr);
-            if (!nbrRouter) continue;
-            if (nbrRouter->routingProtocol() != Router::RoutingProtocol::PIM_DM) continue;
-            if (visited.contains(nbrRouter->id())) continue;
+            bool portHasReceiver = false;
+            for (const Device *pc : port.pcs)
+                if (isReceiver(pc, groupAddr, memberships)) { portHasReceiver = true; break; }
+            receivers = receivers || portHasReceiver;
 
-            const QString nbrInIface = network->interfaceForLink(link, nbrRouter->id());
-            queue.enqueue({nbrRouter->id(), node.routerId, nbrInIface});
+            if (childWants || (portHasReceiver && port.viaLayer2))
+                oil[i].append(port.iface);
         }
+        downstream[i] = receivers || !oil[i].isEmpty();
     }
 
-    // -----------------------------------------------------------------------
-    // For each flooded router, determine OIL and prune leaves without PCs
-    // -----------------------------------------------------------------------
-    for (const BfsNode &node : flood) {
-        Router *r = qobject_cast<Router *>(network->device(node.routerId));
-        if (!r) continue;
-
-        // Gather all outgoing interfaces (toward downstream PIM-DM routers)
-        QStringList oil;
-        bool hasDownstreamPc = false;
-
-        for (const Link *link : network->linksForDevice(node.routerId)) {
-            Device *nbr = network->neighbor(link, node.routerId);
-            Router *nbrRouter = qobject_cast<Router *>(nbr);
-
-            // Check for directly-connected PCs (through this router)
-            if (qobject_cast<PC *>(nbr)) { hasDownstreamPc = true; continue; }
-
-            // Non-PIM-DM or back-toward-parent: skip
-            if (!nbrRouter) {
-                // Switch/hub – check if any PC is downstream
-                if (qobject_cast<Switch *>(nbr) || qobject_cast<Hub *>(nbr)) {
-                    QSet<QString> vis2;
-                    if (hasPcDownstream(nbr->id(), node.routerId, network, vis2)) {
-                        hasDownstreamPc = true;
-                        const QString oif = network->interfaceForLink(link, node.routerId);
-                        oil.append(oif);
-                    }
-                }
-                continue;
-            }
-            if (nbrRouter->routingProtocol() != Router::RoutingProtocol::PIM_DM) continue;
-            if (nbrRouter->id() == node.parentId) continue; // RPF interface
-
-            // Downstream PIM-DM router – include in OIL only if it has receivers
-            QSet<QString> vis2;
-            if (hasPcDownstream(nbrRouter->id(), node.routerId, network, vis2)) {
-                const QString oif = network->interfaceForLink(link, node.routerId);
-                oil.append(oif);
-            } else {
-                tree.pruned.append(nbrRouter->name());
-            }
-        }
-
-        if (!hasDownstreamPc && oil.isEmpty() && node.routerId != firstHop->id()) {
-            tree.pruned.append(r->name());
+    for (int i = 0; i < n; ++i) {
+        const FloodNode &node = flood.nodes[i];
+        if (!downstream[i] && i != 0) {
+            tree.pruned.append(node.router->name());
             continue; // this router is pruned
         }
 
         MulticastTreeEntry entry;
-        entry.routerName          = r->name();
-        entry.routerId            = r->id();
+        entry.routerName          = node.router->name();
+        entry.routerId            = node.router->id();
         entry.incomingInterface   = node.inIface;
-        entry.outgoingInterfaces  = oil;
+        entry.outgoingInterfaces  = oil[i];
         tree.entries.append(entry);
     }
 
     return tree;
 }
+
+MulticastTree PIMDenseMode::compute(Network *network,
+                                    const QString &sourceIp,
+                                    const QString &groupAddr)
+{
+    return computeBatch(network, {{sourceIp, groupAddr}}).first();
+}
+
+// ---------------------------------------------------------------------------
+// Batch: flows are bucketed by source; each bucket floods once and prunes
+// per group.  Buckets only read the network, so they run concurrently, each
+// with its own scratch arena.
+// ---------------------------------------------------------------------------
+QList<MulticastTree> PIMDenseMode::computeBatch(Network *network,
+                                                const QList<MulticastFlow> &flows,
+                                                const GroupMemberships &memberships)
+{
+    TRACE_SCOPE("PIMDenseMode::computeBatch");
+    QHash<QString, QList<int>> flowsBySource; // sourceIp -> indexes into flows
+    QStringList sources;
+    for (int i = 0; i < flows.size(); ++i) {
+        if (!flowsBySource.contains(flows[i].sourceIp)) sources.append(flows[i].sourceIp);
+        flowsBySource[flows[i].sourceIp].append(i);
+    }
+
+    const PimTopology topo = buildTopology(network);
+
+    using IndexedTree = QPair<int, MulticastTree>;
+    auto buildSource = [&](const QString &sourceIp) {
+        TRACE_SCOPE("PIMDenseMode::source");
+        ScratchArena arena;
+        const SourceFlood flood = floodFrom(sourceIp, topo, network, arena);
+        QList<IndexedTree> trees;
+        for (int i : flowsBySource.value(sourceIp))
+            trees.append({i, pruneFlood(flood, topo, sourceIp, flows[i].groupAddress, memberships,
+                                        arena)});
+        return trees;
+    };
+
+    const QList<QList<IndexedTree>> perSource =
+        QtConcurrent::blockingMapped<QList<QList<IndexedTree>>>(sources, buildSource);
+
+    QList<MulticastTree> result(flows.size());
+    for (const auto &trees : perSource)
+        for (const IndexedTree &t : trees)
+            result[t.first] = t.second;
+    return result;
+}
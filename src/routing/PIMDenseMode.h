@@ -1,6 +1,8 @@
 #pragma once
 #include <QString>
 #include <QList>
+#include <QHash>
+#include <QStringList>
 
 class Network;
 
@@ -18,6 +20,15 @@ struct MulticastTree {
     QStringList pruned;                // router names that were pruned
 };
 
+struct MulticastFlow {
+    QString sourceIp;
+    QString groupAddress;
+};
+
+// PC id -> groups the PC has joined.  An empty map treats every PC as a
+// receiver of every group.
+using GroupMemberships = QHash<QString, QStringList>;
+
 class PIMDenseMode
 {
 public:
@@ -25,7 +36,17 @@ public:
     // sourceIp:    IP of the multicast source (typically a PC or loopback)
     // groupAddr:   multicast group address (e.g. 239.1.1.1)
     // Returns one MulticastTree describing the flood-and-prune result.
+    // Each router's incoming interface is its RPF interface toward the source
+    // in its unicast table, so RoutingEngine::run must have populated the
+    // tables first.
     static MulticastTree compute(Network *network,
                                  const QString &sourceIp,
                                  const QString &groupAddr);
+
+    // Builds one tree per flow, in the order given.  The flood from each
+    // distinct source is computed once and shared by all of its groups;
+    // sources are processed in parallel.
+    static QList<MulticastTree> computeBatch(Network *network,
+                                             const QList<MulticastFlow> &flows,
+                                             const GroupMemberships &memberships = {});
 };
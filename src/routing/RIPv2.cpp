@@ -1,33 +1,34 @@
 #include "routing/RIPv2.h"
+#include "routing/SimulationStats.h"
 #include "models/Network.h"
+#include "utils/Trace.h"
 #include "utils/IpUtils.h"
-#include <QHash>
+#include "utils/ScratchArena.h"
 #include <QString>
 
 // Helpers
-static QString routeKey(const QString &dest, const QString &mask)
-{
-    return dest + "/" + mask;
-}
-
 static QString ipOnLink(Router *router, const Link *link, Network *network)
 {
     const QString ifaceName = network->interfaceForLink(link, router->id());
     if (const NetworkInterface *iface = router->getInterface(ifaceName))
-        return iface->ipAddress;
+        return iface->ipAddress();
     return {};
 }
 
-void RIPv2::compute(Network *network)
+static void learn(ScratchArena::Vector<int> &rows, int row, int from)
 {
+    if (row >= static_cast<int>(rows.size())) rows.resize(row + 1, -1);
+    rows[row] = from;
+}
+
+void RIPv2::compute(Network *network, SimulationStats *stats)
+{
+    TRACE_SCOPE("RIPv2::compute");
     // -----------------------------------------------------------------------
     // Step 1: Initialise each RIPv2 router with directly-connected routes.
     // -----------------------------------------------------------------------
-    const QList<Router *> allRouters = network->routers();
-    QList<Router *> ripRouters;
-    for (auto *r : allRouters) {
-        if (r->routingProtocol() != Router::RoutingProtocol::RIPv2) continue;
-        ripRouters.append(r);
+    const QList<Router *> &ripRouters = network->routers(Router::RoutingProtocol::RIPv2);
+    for (auto *r : ripRouters) {
         r->clearRoutingTable();
 
         for (const auto &iface : r->interfaces()) {
@@ -35,11 +36,11 @@ void RIPv2::compute(Network *network)
             quint32 net = iface.networkAddr();
             RoutingEntry e;
             e.destination  = IpUtils::format(net);
-            e.mask         = iface.subnetMask;
-            e.nextHop      = "directly connected";
+            e.mask         = iface.subnetMask();
+            e.nextHop      = QStringLiteral("directly connected");
             e.exitInterface = iface.name;
             e.metric       = 1;
-            e.protocol     = "Connected";
+            e.protocol     = QStringLiteral("Connected");
             r->addRoutingEntry(e);
         }
     }
@@ -47,17 +48,26 @@ void RIPv2::compute(Network *network)
     // -----------------------------------------------------------------------
     // Step 2: Bellman-Ford – iterate until convergence or metric 16 reached.
     // -----------------------------------------------------------------------
-    // We track for each (router, routeKey) which router it was learned from
-    // to apply split horizon.
-    QHash<QString /*routerId*/, QHash<QString /*routeKey*/, QString /*learnedFrom*/>> learnedFrom;
+    // We track for each (router, table row) which router it was learned from
+    // to apply split horizon.  Rows are only appended during the run, so a row
+    // index names a route for its whole life.  Scratch state is indexed by
+    // position in ripRouters and lives in one arena released on return.
+    const int n = static_cast<int>(ripRouters.size());
+    ScratchArena arena;
+    ScratchArena::Hash<const Router *, int> indexOf(arena.resource());
+    for (int i = 0; i < n; ++i) indexOf.emplace(ripRouters[i], i);
+
+    ScratchArena::Vector<ScratchArena::Vector<int>> learnedFrom(n, arena.resource()); // -1: not learned
 
     const int MAX_METRIC = 15;
     bool changed = true;
 
     while (changed) {
         changed = false;
+        if (stats) ++stats->ripIterations;
 
-        for (auto *router : ripRouters) {
+        for (int r = 0; r < n; ++r) {
+            Router *router = ripRouters[r];
             const auto links = network->linksForDevice(router->id());
             for (const Link *link : links) {
                 Device *neighborDev = network->neighbor(link, router->id());
@@ -65,15 +75,17 @@ void RIPv2::compute(Network *network)
                 if (!neighbor || neighbor->routingProtocol() != Router::RoutingProtocol::RIPv2)
                     continue;
 
+                const int nbr = indexOf.at(neighbor);
                 const QString neighborIfaceName = network->interfaceForLink(link, neighbor->id());
                 const QString routerIp = ipOnLink(router, link, network);
 
                 // Advertise our routing table to the neighbor
-                for (const auto &entry : router->computedRoutingTable()) {
-                    const QString key = routeKey(entry.destination, entry.mask);
+                const QList<RoutingEntry> &table = router->computedRoutingTable();
+                for (int row = 0; row < table.size(); ++row) {
+                    const RoutingEntry &entry = table[row];
 
                     // Split horizon: do not advertise back to where we learned it
-                    if (learnedFrom[router->id()].value(key) == neighbor->id())
+                    if (row < static_cast<int>(learnedFrom[r].size()) && learnedFrom[r][row] == nbr)
                         continue;
 
                     int newMetric = entry.metric + 1;
@@ -81,15 +93,17 @@ void RIPv2::compute(Network *network)
 
                     // Check existing entry in neighbor
                     bool found = false;
-                    for (auto &ne : neighbor->computedRoutingTable()) {
+                    QList<RoutingEntry> &nbrTable = neighbor->computedRoutingTable();
+                    for (int nrow = 0; nrow < nbrTable.size(); ++nrow) {
+                        RoutingEntry &ne = nbrTable[nrow];
                         if (ne.destination == entry.destination && ne.mask == entry.mask) {
                             found = true;
                             if (newMetric < ne.metric) {
                                 ne.metric        = newMetric;
                                 ne.nextHop       = routerIp;
                                 ne.exitInterface = neighborIfaceName;
-                                ne.protocol      = "RIPv2";
-                                learnedFrom[neighbor->id()][key] = router->id();
+                                ne.protocol      = QStringLiteral("RIPv2");
+                                learn(learnedFrom[nbr], nrow, r);
                                 changed = true;
                             }
                             break;
@@ -102,9 +116,9 @@ void RIPv2::compute(Network *network)
                         ne.nextHop      = routerIp;
                         ne.exitInterface = neighborIfaceName;
                         ne.metric       = newMetric;
-                        ne.protocol     = "RIPv2";
+                        ne.protocol     = QStringLiteral("RIPv2");
                         neighbor->addRoutingEntry(ne);
-                        learnedFrom[neighbor->id()][key] = router->id();
+                        learn(learnedFrom[nbr], static_cast<int>(nbrTable.size()) - 1, r);
                         changed = true;
                     }
                 }
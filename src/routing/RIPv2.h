@@ -1,9 +1,11 @@
 #pragma once
 class Network;
+struct SimulationStats;
 
 class RIPv2
 {
 public:
     // Populates computedRoutingTable on every RIPv2 router in the network.
-    static void compute(Network *network);
+    // Adds the number of Bellman-Ford passes to 'stats' when given.
+    static void compute(Network *network, SimulationStats *stats = nullptr);
 };
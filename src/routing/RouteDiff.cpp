@@ -0,0 +1,104 @@
+#include "routing/RouteDiff.h"
+#include "utils/IpUtils.h"
+#include <QHash>
+
+// (destination, prefix length) as one join key.  IPv4 routes sit in the
+// IPv4-mapped range (::ffff:0:0/96), so both families share one table.
+struct RouteKey {
+    IpUtils::Ip6Address destination;
+    int                 length = 0;
+
+    friend bool operator==(const RouteKey &a, const RouteKey &b)
+    {
+        return a.length == b.length && a.destination == b.destination;
+    }
+};
+
+static size_t qHash(const RouteKey &k, size_t seed = 0)
+{
+    return qHashMulti(seed, k.destination, k.length);
+}
+
+static RouteKey routeKey(const RoutingEntry &e)
+{
+    if (e.isIpv6()) {
+        const int length = QStringView(e.mask).mid(1).toInt();
+        return {IpUtils::parse6(e.destination), length};
+    }
+    const quint32 mask = IpUtils::parse(e.mask);
+    const IpUtils::Ip6Address mapped{0, 0xFFFF00000000ull | IpUtils::parse(e.destination)};
+    return {mapped, 96 + IpUtils::maskToPrefix(mask)};
+}
+
+static void diffTables(const RouterSimResult *before, const RouterSimResult *after,
+                       RouteDiffResult &result)
+{
+    const RouterSimResult &named = after ? *after : *before;
+    const int changesBefore = static_cast<int>(result.changes.size());
+
+    auto record = [&](RouteChange::Kind kind, const RoutingEntry &b, const RoutingEntry &a) {
+        result.changes.append({kind, named.routerId, named.routerName, b, a});
+    };
+
+    // Build side: the previous table.  Duplicate prefixes keep the first row,
+    // matching longest-prefix lookup order.
+    QHash<RouteKey, int> previous;
+    QList<bool>         matched;
+    if (before) {
+        previous.reserve(before->routingTable.size());
+        for (int i = 0; i < before->routingTable.size(); ++i) {
+            const RouteKey key = routeKey(before->routingTable[i]);
+            if (!previous.contains(key)) previous.insert(key, i);
+        }
+        matched.fill(false, before->routingTable.size());
+    }
+
+    // Probe side: the new table
+    if (after) {
+        for (const RoutingEntry &a : after->routingTable) {
+            const auto it = previous.constFind(routeKey(a));
+            if (it == previous.constEnd() || matched[it.value()]) {
+                record(RouteChange::Kind::Added, {}, a);
+                ++result.added;
+                continue;
+            }
+            matched[it.value()] = true;
+            const RoutingEntry &b = before->routingTable[it.value()];
+            if (a.nextHop != b.nextHop || a.exitInterface != b.exitInterface) {
+                record(RouteChange::Kind::NextHopChanged, b, a);
+                ++result.nextHopChanged;
+            } else if (a.metric != b.metric || a.protocol != b.protocol) {
+                record(RouteChange::Kind::MetricChanged, b, a);
+                ++result.metricChanged;
+            }
+        }
+    }
+
+    if (before)
+        for (int i = 0; i < before->routingTable.size(); ++i)
+            if (!matched[i]) {
+                record(RouteChange::Kind::Removed, before->routingTable[i], {});
+                ++result.removed;
+            }
+
+    if (result.changes.size() > changesBefore) ++result.routersChanged;
+}
+
+// ---------------------------------------------------------------------------
+RouteDiffResult RouteDiff::compute(const SimulationResult &before, const SimulationResult &after)
+{
+    RouteDiffResult result;
+
+    QHash<QString, const RouterSimResult *> previous;
+    for (const RouterSimResult &rr : before.routerResults) previous.insert(rr.routerId, &rr);
+
+    for (const RouterSimResult &rr : after.routerResults)
+        diffTables(previous.take(rr.routerId), &rr, result);
+
+    // Routers that disappeared, in their original order
+    for (const RouterSimResult &rr : before.routerResults)
+        if (previous.contains(rr.routerId))
+            diffTables(&rr, nullptr, result);
+
+    return result;
+}
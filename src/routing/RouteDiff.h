@@ -0,0 +1,48 @@
+#pragma once
+#include <QString>
+#include <QList>
+#include "routing/RoutingEngine.h"
+
+struct RouteChange {
+    enum class Kind { Added, Removed, NextHopChanged, MetricChanged };
+
+    Kind         kind;
+    QString      routerId;
+    QString      routerName;
+    RoutingEntry before; // empty for Added
+    RoutingEntry after;  // empty for Removed
+
+    QString kindString() const {
+        switch (kind) {
+            case Kind::Added:          return "ADDED";
+            case Kind::Removed:        return "REMOVED";
+            case Kind::NextHopChanged: return "NEXT HOP";
+            case Kind::MetricChanged:  return "METRIC";
+        }
+        return {};
+    }
+};
+
+struct RouteDiffResult {
+    QList<RouteChange> changes; // grouped by router, in the 'after' router order
+    int added          = 0;
+    int removed        = 0;
+    int nextHopChanged = 0;
+    int metricChanged  = 0;
+    int routersChanged = 0;
+
+    bool isEmpty() const { return changes.isEmpty(); }
+};
+
+class RouteDiff
+{
+public:
+    // Compares two simulation runs router by router (matched by id), joining
+    // each pair of tables on (destination, mask) through a hash table, so the
+    // cost is linear in the number of routes.  A route whose next hop or exit
+    // interface differs is NextHopChanged; otherwise a metric or protocol
+    // difference is MetricChanged.  Routers present in only one run have all
+    // their routes reported as added or removed.
+    static RouteDiffResult compute(const SimulationResult &before,
+                                   const SimulationResult &after);
+};
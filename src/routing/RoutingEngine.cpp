@@ -4,55 +4,134 @@
 #include "routing/StaticRouting.h"
 #include "routing/PIMDenseMode.h"
 #include "models/Network.h"
+#include "utils/Trace.h"
+#include <QElapsedTimer>
 
 SimulationResult RoutingEngine::run(Network *network,
                                     const QString &pimSourceIp,
                                     const QString &pimGroupAddr)
 {
-    SimulationResult result;
+    QList<MulticastFlow> flows;
+    if (!pimSourceIp.isEmpty() && !pimGroupAddr.isEmpty())
+        flows.append({pimSourceIp, pimGroupAddr});
+    return run(network, flows);
+}
 
-    // Run each unicast protocol
-    StaticRouting::compute(network);
-    RIPv2::compute(network);
-    OSPF::compute(network);
-    // PIM-DM routers also get their connected routes via their own compute pass
-    // (we reuse the OSPF infrastructure; here we add connected routes manually)
-    for (auto *router : network->routers()) {
-        if (router->routingProtocol() != Router::RoutingProtocol::PIM_DM) continue;
-        router->clearRoutingTable();
-        for (const auto &iface : router->interfaces()) {
-            if (!iface.isConfigured()) continue;
-            RoutingEntry e;
-            e.destination  = IpUtils::format(iface.networkAddr());
-            e.mask         = iface.subnetMask;
-            e.nextHop      = "directly connected";
-            e.exitInterface = iface.name;
-            e.metric       = 0;
-            e.protocol     = "Connected";
-            router->addRoutingEntry(e);
-        }
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+static QString protocolName(Router::RoutingProtocol protocol)
+{
+    switch (protocol) {
+        case Router::RoutingProtocol::Static: return "Static";
+        case Router::RoutingProtocol::RIPv2:  return "RIPv2";
+        case Router::RoutingProtocol::OSPF:   return "OSPF";
+        case Router::RoutingProtocol::PIM_DM: return "PIM Dense Mode";
     }
+    return {};
+}
 
-    // Collect per-router results
-    for (auto *router : network->routers()) {
-        RouterSimResult rr;
-        rr.routerId   = router->id();
-        rr.routerName = router->name();
-        switch (router->routingProtocol()) {
-            case Router::RoutingProtocol::Static: rr.protocol = "Static";        break;
-            case Router::RoutingProtocol::RIPv2:  rr.protocol = "RIPv2";         break;
-            case Router::RoutingProtocol::OSPF:   rr.protocol = "OSPF";          break;
-            case Router::RoutingProtocol::PIM_DM: rr.protocol = "PIM Dense Mode"; break;
+// Problems that leave a router with fewer routes than the user probably
+// expects; the Validator covers addressing mistakes in more depth.
+static QStringList routerWarnings(Network *network, const Router *router)
+{
+    QStringList warnings;
+
+    bool anyConfigured = false;
+    for (const auto &iface : router->interfaces())
+        anyConfigured = anyConfigured || iface.isConfigured();
+    if (!anyConfigured)
+        warnings << "No configured interfaces; routing table is empty";
+
+    for (const auto &e : router->computedRoutingTable())
+        if (e.protocol == "Static" && e.exitInterface.isEmpty())
+            warnings << QString("Static route %1/%2: next hop %3 is not on a connected subnet")
+                            .arg(e.destination, e.mask, e.nextHop);
+
+    if (router->routingProtocol() != Router::RoutingProtocol::Static) {
+        for (const Link *link : network->linksForDevice(router->id())) {
+            auto *nbr = qobject_cast<Router *>(network->neighbor(link, router->id()));
+            if (!nbr || nbr->routingProtocol() == router->routingProtocol()) continue;
+            warnings << QString("Neighbor %1 on %2 runs %3; no routes are exchanged with it")
+                            .arg(nbr->name(), network->interfaceForLink(link, router->id()),
+                                 protocolName(nbr->routingProtocol()));
         }
-        rr.routingTable = router->computedRoutingTable();
-        result.routerResults.append(rr);
     }
+    return warnings;
+}
+
+// Drops the result's references to the router tables, so clearing a table
+// for the next run truncates it in place instead of detaching a new buffer.
+static void releaseTables(SimulationResult &result)
+{
+    for (RouterSimResult &rr : result.routerResults)
+        rr.routingTable = QList<RoutingEntry>();
+    result.multicastTrees.clear();
+    result.stats = SimulationStats();
+}
 
-    // PIM-DM multicast tree (if requested)
-    if (!pimSourceIp.isEmpty() && !pimGroupAddr.isEmpty()) {
-        MulticastTree tree = PIMDenseMode::compute(network, pimSourceIp, pimGroupAddr);
-        result.multicastTrees.append(tree);
+// Per-router results from the computed tables, overwriting earlier rows in place
+static void collectResults(Network *network, SimulationResult &result)
+{
+    TRACE_SCOPE("RoutingEngine::collect");
+    const QList<Router *> &routers = network->routers();
+    result.routerResults.resize(routers.size());
+    for (int i = 0; i < routers.size(); ++i) {
+        const Router *router = routers[i];
+        RouterSimResult &rr = result.routerResults[i];
+        rr.routerId     = router->id();
+        rr.routerName   = router->name();
+        rr.protocol     = protocolName(router->routingProtocol());
+        rr.routingTable = router->computedRoutingTable(); // shared, not copied
+        rr.warnings     = routerWarnings(network, router);
+        result.stats.routesInstalled += rr.routingTable.size();
     }
+}
 
+// ---------------------------------------------------------------------------
+SimulationResult RoutingEngine::run(Network *network, const QList<MulticastFlow> &pimFlows)
+{
+    SimulationResult result;
+    run(network, pimFlows, result);
     return result;
 }
+
+void RoutingEngine::run(Network *network, const QList<MulticastFlow> &pimFlows,
+                        SimulationResult &result)
+{
+    TRACE_SCOPE("RoutingEngine::run");
+    releaseTables(result);
+    SimulationStats &stats = result.stats;
+    QElapsedTimer timer;
+    auto phase = [&](const char *name) {
+        stats.phases.append({name, timer.nsecsElapsed()});
+        timer.restart();
+    };
+    timer.start();
+
+    // Run each unicast protocol
+    StaticRouting::compute(network);
+    phase("Static");
+    RIPv2::compute(network, &stats);
+    phase("RIPv2");
+    OSPF::compute(network, &stats);
+    phase("OSPF");
+
+    // PIM-DM routers run the same SPF among themselves, so RPF checks have
+    // unicast routes toward every source inside the PIM-DM domain.  Then the
+    // multicast trees (if requested).
+    OSPF::computeFor(network, Router::RoutingProtocol::PIM_DM, "PIM-DM", &stats);
+    if (!pimFlows.isEmpty()) {
+        GroupMemberships memberships;
+        for (auto *pc : network->pcs())
+            if (!pc->multicastGroups().isEmpty())
+                memberships.insert(pc->id(), pc->multicastGroups());
+        result.multicastTrees = PIMDenseMode::computeBatch(network, pimFlows, memberships);
+    }
+    phase("PIM-DM");
+
+    collectResults(network, result);
+    phase("Collect");
+
+    stats.peakRssKb = SimulationStats::currentPeakRssKb();
+}
@@ -3,6 +3,7 @@
 #include <QList>
 #include "models/Device.h"
 #include "routing/PIMDenseMode.h"
+#include "routing/SimulationStats.h"
 
 class Network;
 
@@ -10,13 +11,22 @@ struct RouterSimResult {
     QString             routerId;
     QString             routerName;
     QString             protocol;
-    QList<RoutingEntry> routingTable;
-    QStringList         warnings;
+    QList<RoutingEntry> routingTable; // shares the router's computed table
+    QStringList         warnings;     // configuration problems seen while computing
 };
 
+// ---------------------------------------------------------------------------
+// SimulationResult
+//
+// Every member is implicitly shared, so copying a result (to keep a baseline
+// for RouteDiff, say) copies no rows: the routing tables stay shared with the
+// routers until the next run rewrites them, which detaches only the tables of
+// routers whose old result is still held somewhere.
+// ---------------------------------------------------------------------------
 struct SimulationResult {
     QList<RouterSimResult> routerResults;
     QList<MulticastTree>   multicastTrees; // one per PIM-DM source/group pair
+    SimulationStats        stats;
 };
 
 class RoutingEngine
@@ -26,4 +36,15 @@ public:
     static SimulationResult run(Network *network,
                                 const QString &pimSourceIp  = QString(),
                                 const QString &pimGroupAddr = QString());
+
+    // Same, building one multicast tree per (source, group) flow.  PCs'
+    // configured multicast groups decide which PCs are receivers.
+    static SimulationResult run(Network *network, const QList<MulticastFlow> &pimFlows);
+
+    // Same, refilling 'result' from a previous run in place.  Its lists keep
+    // their capacity, and the router tables it shared are released first, so
+    // every protocol pass rebuilds its tables in their existing buffers.
+    // Meant for callers that run one topology many times.
+    static void run(Network *network, const QList<MulticastFlow> &pimFlows,
+                    SimulationResult &result);
 };
@@ -0,0 +1,49 @@
+#include "routing/SimulationStats.h"
+#include <QtGlobal>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+qint64 SimulationStats::totalNsecs() const
+{
+    qint64 total = 0;
+    for (const PhaseTiming &p : phases) total += p.nsecs;
+    return total;
+}
+
+double SimulationStats::phaseMs(const QString &phase) const
+{
+    for (const PhaseTiming &p : phases)
+        if (p.name == phase) return p.nsecs / 1e6;
+    return 0.0;
+}
+
+QString SimulationStats::summary() const
+{
+    QString s;
+    for (const PhaseTiming &p : phases)
+        s += QString("  %1 %2 ms\n").arg(p.name + ':', -10).arg(p.nsecs / 1e6, 10, 'f', 3);
+    s += QString("  %1 %2 ms\n").arg("Total:", -10).arg(totalNsecs() / 1e6, 10, 'f', 3);
+    s += QString("  RIP iterations: %1, SPF runs: %2, heap ops: %3\n")
+             .arg(ripIterations).arg(spfRuns).arg(heapOps);
+    s += QString("  Routes installed: %1, peak memory: %2\n")
+             .arg(routesInstalled)
+             .arg(peakRssKb < 0 ? QString("n/a") : QString("%1 MiB").arg(peakRssKb / 1024.0, 0, 'f', 1));
+    return s;
+}
+
+qint64 SimulationStats::currentPeakRssKb()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#  ifdef Q_OS_MACOS
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#  else
+    return usage.ru_maxrss;        // KiB on Linux and the BSDs
+#  endif
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <QList>
+#include <QString>
+
+// ---------------------------------------------------------------------------
+// SimulationStats
+//
+// Work and timing counters gathered during RoutingEngine::run().  Protocol
+// compute functions take an optional pointer and add to the counters they
+// own; phase timings are recorded by the engine around each protocol.
+// ---------------------------------------------------------------------------
+struct PhaseTiming {
+    QString name;
+    qint64  nsecs = 0;
+};
+
+struct SimulationStats {
+    QList<PhaseTiming> phases;          // in execution order
+
+    int    ripIterations   = 0;         // Bellman-Ford passes until convergence
+    int    spfRuns         = 0;         // one per OSPF / PIM-DM root router
+    qint64 heapOps         = 0;         // SPF extract-min + decrease-key operations
+    qint64 routesInstalled = 0;         // entries across all computed tables
+    qint64 peakRssKb       = -1;        // process high-water mark; -1 if unknown
+
+    qint64 totalNsecs() const;
+    // Milliseconds spent in 'phase', or 0 if it did not run
+    double phaseMs(const QString &phase) const;
+
+    // Multi-line plain-text rendering for logs and the test runner
+    QString summary() const;
+
+    // Peak resident set size of this process in KiB, or -1 if unavailable
+    static qint64 currentPeakRssKb();
+};
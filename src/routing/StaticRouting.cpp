@@ -1,11 +1,43 @@
 #include "routing/StaticRouting.h"
 #include "models/Network.h"
+#include "utils/Trace.h"
 #include "utils/IpUtils.h"
 
+// An IPv6 static route, normalised to "network" + "/len" when it parses.  The
+// exit interface is the one whose IPv6 prefix holds the next hop.
+static RoutingEntry ipv6StaticRoute(const Router *router, const Router::StaticRoute &sr)
+{
+    RoutingEntry e;
+    e.destination = sr.destination;
+    e.mask        = sr.mask;
+    e.nextHop     = sr.nextHop;
+    e.metric      = sr.metric;
+    e.protocol    = QStringLiteral("Static");
+
+    IpUtils::ParseError error;
+    const IpUtils::Ip6Address dest = IpUtils::parse6(sr.destination, &error);
+    bool lengthOk = false;
+    const int length = QStringView(sr.mask).mid(sr.mask.startsWith('/') ? 1 : 0).toInt(&lengthOk);
+    if (error == IpUtils::ParseError::None && lengthOk && length >= 0 && length <= 128) {
+        e.destination = IpUtils::format6(dest.masked(length));
+        e.mask        = QString("/%1").arg(length);
+    }
+
+    const IpUtils::Ip6Address nextHop = IpUtils::parse6(sr.nextHop, &error);
+    if (error != IpUtils::ParseError::None) return e;
+    for (const auto &iface : router->interfaces()) {
+        if (iface.hasIpv6() && nextHop.masked(iface.ipv6PrefixLen()) == iface.ipv6Network()) {
+            e.exitInterface = iface.name;
+            break;
+        }
+    }
+    return e;
+}
+
 void StaticRouting::compute(Network *network)
 {
-    for (auto *router : network->routers()) {
-        if (router->routingProtocol() != Router::RoutingProtocol::Static) continue;
+    TRACE_SCOPE("StaticRouting::compute");
+    for (auto *router : network->routers(Router::RoutingProtocol::Static)) {
         router->clearRoutingTable();
 
         // Directly-connected networks
@@ -13,28 +45,44 @@ void StaticRouting::compute(Network *network)
             if (!iface.isConfigured()) continue;
             RoutingEntry e;
             e.destination  = IpUtils::format(iface.networkAddr());
-            e.mask         = iface.subnetMask;
-            e.nextHop      = "directly connected";
+            e.mask         = iface.subnetMask();
+            e.nextHop      = QStringLiteral("directly connected");
+            e.exitInterface = iface.name;
+            e.metric       = 0;
+            e.protocol     = QStringLiteral("Connected");
+            router->addRoutingEntry(e);
+        }
+        for (const auto &iface : router->interfaces()) {
+            if (!iface.hasIpv6()) continue;
+            RoutingEntry e;
+            e.destination  = IpUtils::format6(iface.ipv6Network());
+            e.mask         = QString("/%1").arg(iface.ipv6PrefixLen());
+            e.nextHop      = QStringLiteral("directly connected");
             e.exitInterface = iface.name;
             e.metric       = 0;
-            e.protocol     = "Connected";
+            e.protocol     = QStringLiteral("Connected");
             router->addRoutingEntry(e);
         }
 
         // User-defined static routes
         for (const auto &sr : router->staticRoutes()) {
             if (sr.destination.isEmpty() || sr.mask.isEmpty()) continue;
+            if (IpUtils::isIpv6Text(sr.destination)) {
+                router->addRoutingEntry(ipv6StaticRoute(router, sr));
+                continue;
+            }
             RoutingEntry e;
             e.destination  = sr.destination;
             e.mask         = sr.mask;
             e.nextHop      = sr.nextHop;
             e.metric       = sr.metric;
-            e.protocol     = "Static";
+            e.protocol     = QStringLiteral("Static");
 
             // Determine exit interface by matching next-hop to a connected subnet
+            const quint32 nextHop = IpUtils::parse(sr.nextHop);
             for (const auto &iface : router->interfaces()) {
                 if (!iface.isConfigured()) continue;
-                if (IpUtils::sameSubnet(sr.nextHop, iface.ipAddress, iface.subnetMask)) {
+                if ((nextHop & iface.maskAsUint32()) == iface.networkAddr()) {
                     e.exitInterface = iface.name;
                     break;
                 }
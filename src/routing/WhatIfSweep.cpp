@@ -0,0 +1,342 @@
+#include "routing/WhatIfSweep.h"
+#include "routing/RIPv2.h"
+#include "routing/OSPF.h"
+#include "routing/SimulationStats.h"
+#include "models/Network.h"
+#include "models/DeviceStore.h"
+#include "utils/Trace.h"
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <numeric>
+
+// ---------------------------------------------------------------------------
+// Perturbation
+// ---------------------------------------------------------------------------
+Perturbation Perturbation::linkDown(const QString &linkId)
+{
+    Perturbation p;
+    p.kind = Kind::LinkDown;
+    p.id   = linkId;
+    return p;
+}
+
+Perturbation Perturbation::costChange(const QString &routerId, const QString &interfaceName, int cost)
+{
+    Perturbation p;
+    p.kind          = Kind::CostChange;
+    p.id            = routerId;
+    p.interfaceName = interfaceName;
+    p.cost          = cost;
+    return p;
+}
+
+Perturbation Perturbation::routerDown(const QString &routerId)
+{
+    Perturbation p;
+    p.kind = Kind::RouterDown;
+    p.id   = routerId;
+    return p;
+}
+
+QString Perturbation::describe() const
+{
+    switch (kind) {
+        case Kind::LinkDown:   return QString("link %1 down").arg(id);
+        case Kind::CostChange: return QString("cost %1 on %2 %3").arg(cost).arg(id, interfaceName);
+        case Kind::RouterDown: return QString("router %1 down").arg(id);
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+namespace {
+
+// Read-only state every worker starts from
+struct SweepBaseline {
+    DeviceStore         snapshot;
+    SimulationResult    result;
+    QHash<QString, int> row;   // router id -> index into result.routerResults
+    OSPF::SpfTrees      trees; // OSPF and PIM-DM
+};
+
+struct SpfDomain {
+    QSet<QString> roots; // to recompute
+    bool          all = false;
+};
+
+// What one scenario changed, to recompute the affected routers and undo it
+struct Applied {
+    QList<Link>                         removedLinks;
+    QHash<QPair<QString, QString>, int> baselineCosts; // (router id, interface) -> cost
+    QSet<QString>                       downRouters;
+    SpfDomain                           ospf, pim;
+    bool                                rip = false;
+
+    SpfDomain &domain(Router::RoutingProtocol protocol)
+    {
+        return protocol == Router::RoutingProtocol::OSPF ? ospf : pim;
+    }
+};
+
+} // namespace
+
+static bool isSpfProtocol(Router::RoutingProtocol protocol)
+{
+    return protocol == Router::RoutingProtocol::OSPF || protocol == Router::RoutingProtocol::PIM_DM;
+}
+
+// The SPF passes exactly as RoutingEngine::run() invokes them
+static void runSpf(Network *network, Router::RoutingProtocol protocol, const QSet<QString> *roots,
+                   SimulationStats *stats, OSPF::SpfTrees *trees = nullptr)
+{
+    if (protocol == Router::RoutingProtocol::OSPF)
+        OSPF::computeFor(network, protocol, "OSPF", stats, "OSPFv3", roots, trees);
+    else
+        OSPF::computeFor(network, protocol, "PIM-DM", stats, QString(), roots, trees);
+}
+
+// The routing protocol both ends of 'link' run, if it forms an adjacency
+static bool adjacencyProtocol(Network *network, const Link &link, Router::RoutingProtocol *protocol)
+{
+    auto *r1 = qobject_cast<Router *>(network->device(link.device1Id));
+    auto *r2 = qobject_cast<Router *>(network->device(link.device2Id));
+    if (!r1 || !r2 || r1->routingProtocol() != r2->routingProtocol()) return false;
+    *protocol = r1->routingProtocol();
+    return true;
+}
+
+// A failed link: the roots whose trees cross it, or all of RIPv2
+static void dropLink(Network *network, const Link &link, const SweepBaseline &base, Applied &applied)
+{
+    Router::RoutingProtocol protocol;
+    if (adjacencyProtocol(network, link, &protocol)) {
+        if (protocol == Router::RoutingProtocol::RIPv2)
+            applied.rip = true;
+        else if (isSpfProtocol(protocol))
+            for (const QString &root : base.trees.rootsByLink.value(link.id))
+                applied.domain(protocol).roots.insert(root);
+    }
+    applied.removedLinks.append(link);
+    network->removeLink(link.id);
+}
+
+static void apply(Network *network, const Perturbation &p, const SweepBaseline &base,
+                  Applied &applied, QStringList &errors)
+{
+    if (p.kind == Perturbation::Kind::LinkDown) {
+        const Link *link = network->link(p.id);
+        if (!link) { errors << QString("Unknown link '%1'").arg(p.id); return; }
+        dropLink(network, Link(*link), base, applied);
+        return;
+    }
+
+    auto *router = qobject_cast<Router *>(network->device(p.id));
+    if (!router) { errors << QString("Unknown router '%1'").arg(p.id); return; }
+
+    if (p.kind == Perturbation::Kind::RouterDown) {
+        applied.downRouters.insert(router->id());
+        QList<Link> links; // copied: removing entries moves the others
+        for (const Link *link : network->linksForDevice(router->id())) links.append(*link);
+        for (const Link &link : links) dropLink(network, link, base, applied);
+        return;
+    }
+
+    NetworkInterface *iface = router->getInterface(p.interfaceName);
+    if (!iface) {
+        errors << QString("Unknown interface '%1' on '%2'").arg(p.interfaceName, router->name());
+        return;
+    }
+    const auto key = qMakePair(router->id(), iface->name);
+    if (!applied.baselineCosts.contains(key)) applied.baselineCosts.insert(key, iface->ospfCost);
+    iface->ospfCost = p.cost;
+}
+
+// Cost changes are judged by their net effect once every change is applied:
+// a rise only matters to trees crossing the link, a drop can pull any tree
+static void markCostChanges(Network *network, const SweepBaseline &base, Applied &applied)
+{
+    for (auto it = applied.baselineCosts.cbegin(); it != applied.baselineCosts.cend(); ++it) {
+        auto *router = qobject_cast<Router *>(network->device(it.key().first));
+        const int cost = router->getInterface(it.key().second)->ospfCost;
+        if (cost == it.value() || !isSpfProtocol(router->routingProtocol())) continue;
+
+        for (const Link *link : network->linksForDevice(router->id())) {
+            Router::RoutingProtocol protocol;
+            if (network->interfaceForLink(link, router->id()) != it.key().second ||
+                !adjacencyProtocol(network, *link, &protocol))
+                continue;
+            SpfDomain &domain = applied.domain(protocol);
+            if (cost < it.value())
+                domain.all = true;
+            else
+                for (const QString &root : base.trees.rootsByLink.value(link->id))
+                    domain.roots.insert(root);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// One scenario on a worker's network, which starts and ends at the baseline
+// ---------------------------------------------------------------------------
+static WhatIfOutcome evaluate(Network *network, const SweepBaseline &base,
+                              const WhatIfScenario &scenario)
+{
+    TRACE_SCOPE("WhatIfSweep::scenario");
+    WhatIfOutcome outcome;
+    outcome.scenario = scenario.name;
+
+    Applied applied;
+    for (const Perturbation &p : scenario.changes)
+        apply(network, p, base, applied, outcome.errors);
+    markCostChanges(network, base, applied);
+
+    // Recompute what the changes can reach; note every router touched
+    SimulationStats stats;
+    QSet<QString> touched = applied.downRouters;
+    if (applied.rip) {
+        RIPv2::compute(network, &stats);
+        for (const Router *r : network->routers(Router::RoutingProtocol::RIPv2)) touched.insert(r->id());
+    }
+    for (auto protocol : {Router::RoutingProtocol::OSPF, Router::RoutingProtocol::PIM_DM}) {
+        SpfDomain &domain = applied.domain(protocol);
+        if (domain.all) {
+            runSpf(network, protocol, nullptr, &stats);
+            for (const Router *r : network->routers(protocol)) touched.insert(r->id());
+        } else {
+            domain.roots.subtract(applied.downRouters);
+            if (domain.roots.isEmpty()) continue;
+            runSpf(network, protocol, &domain.roots, &stats);
+            touched.unite(domain.roots);
+        }
+    }
+    outcome.spfRuns = stats.spfRuns;
+
+    // Diff only the touched routers; the rest kept their baseline tables
+    SimulationResult before, after;
+    for (const RouterSimResult &rr : base.result.routerResults) {
+        if (!touched.contains(rr.routerId)) continue;
+        before.routerResults.append(rr);
+        if (applied.downRouters.contains(rr.routerId)) continue; // all of its routes are gone
+        RouterSimResult now = rr;
+        now.routingTable = qobject_cast<Router *>(network->device(rr.routerId))->computedRoutingTable();
+        after.routerResults.append(now);
+    }
+    outcome.diff = RouteDiff::compute(before, after);
+
+    // Undo
+    for (const Link &link : applied.removedLinks) network->addLink(link);
+    for (auto it = applied.baselineCosts.cbegin(); it != applied.baselineCosts.cend(); ++it)
+        network->device(it.key().first)->getInterface(it.key().second)->ospfCost = it.value();
+    for (const QString &id : touched) {
+        const int row = base.row.value(id, -1);
+        if (row >= 0)
+            qobject_cast<Router *>(network->device(id))->computedRoutingTable() =
+                base.result.routerResults[row].routingTable;
+    }
+    return outcome;
+}
+
+// Scenarios first, first + stride, ... on a private copy of the network
+static QList<WhatIfOutcome> runWorker(const SweepBaseline &base, const QList<WhatIfScenario> &scenarios,
+                                      int first, int stride)
+{
+    Network network;
+    base.snapshot.toNetwork(&network);
+    for (const RouterSimResult &rr : base.result.routerResults)
+        if (auto *r = qobject_cast<Router *>(network.device(rr.routerId)))
+            r->computedRoutingTable() = rr.routingTable; // shared with the baseline
+
+    QList<WhatIfOutcome> outcomes;
+    for (int i = first; i < scenarios.size(); i += stride)
+        outcomes.append(evaluate(&network, base, scenarios[i]));
+    return outcomes;
+}
+
+// ---------------------------------------------------------------------------
+WhatIfResult WhatIfSweep::run(const Network *base, const QList<WhatIfScenario> &scenarios)
+{
+    TRACE_SCOPE("WhatIfSweep::run");
+    SweepBaseline baseline;
+    baseline.snapshot = DeviceStore::fromNetwork(base);
+    {
+        Network network;
+        baseline.snapshot.toNetwork(&network);
+        baseline.result = RoutingEngine::run(&network);
+        // The SPF passes again, unchanged, to record which links each tree uses
+        runSpf(&network, Router::RoutingProtocol::OSPF, nullptr, nullptr, &baseline.trees);
+        runSpf(&network, Router::RoutingProtocol::PIM_DM, nullptr, nullptr, &baseline.trees);
+    }
+    for (int i = 0; i < baseline.result.routerResults.size(); ++i)
+        baseline.row.insert(baseline.result.routerResults[i].routerId, i);
+
+    WhatIfResult result;
+    result.baseline = baseline.result;
+    if (scenarios.isEmpty()) return result;
+
+    // Scenarios are dealt round-robin so expensive neighbours spread out
+    const int workers = qMin(qMax(1, QThread::idealThreadCount()), int(scenarios.size()));
+    QList<int> firsts(workers);
+    std::iota(firsts.begin(), firsts.end(), 0);
+    const QList<QList<WhatIfOutcome>> perWorker =
+        QtConcurrent::blockingMapped<QList<QList<WhatIfOutcome>>>(firsts, [&](int first) {
+            return runWorker(baseline, scenarios, first, workers);
+        });
+
+    result.outcomes.reserve(scenarios.size());
+    for (int i = 0; i < scenarios.size(); ++i)
+        result.outcomes.append(perWorker[i % workers][i / workers]);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Scenario lists
+// ---------------------------------------------------------------------------
+QList<WhatIfScenario> WhatIfSweep::linkFailures(const Network *network)
+{
+    QList<const Link *> links = network->links();
+    std::sort(links.begin(), links.end(), [](const Link *a, const Link *b) { return a->id < b->id; });
+
+    QList<WhatIfScenario> scenarios;
+    for (const Link *link : links) {
+        const Device *d1 = network->device(link->device1Id);
+        const Device *d2 = network->device(link->device2Id);
+        WhatIfScenario s;
+        s.name = QString("Link %1 %2 - %3 %4 down")
+                     .arg(d1 ? d1->name() : link->device1Id, link->interface1,
+                          d2 ? d2->name() : link->device2Id, link->interface2);
+        s.changes.append(Perturbation::linkDown(link->id));
+        scenarios.append(s);
+    }
+    return scenarios;
+}
+
+QList<WhatIfScenario> WhatIfSweep::routerFailures(const Network *network)
+{
+    QList<WhatIfScenario> scenarios;
+    for (const Router *router : network->routers()) {
+        WhatIfScenario s;
+        s.name = QString("Router %1 down").arg(router->name());
+        s.changes.append(Perturbation::routerDown(router->id()));
+        scenarios.append(s);
+    }
+    return scenarios;
+}
+
+WhatIfScenario WhatIfSweep::scaledCosts(const Network *network, double factor)
+{
+    WhatIfScenario scenario;
+    scenario.name = QString("OSPF costs x%1").arg(factor);
+    for (auto protocol : {Router::RoutingProtocol::OSPF, Router::RoutingProtocol::PIM_DM})
+        for (const Router *router : network->routers(protocol))
+            for (const auto &iface : router->interfaces()) {
+                const int cost = qMax(1, qRound(iface.ospfCost * factor));
+                if (cost != iface.ospfCost)
+                    scenario.changes.append(Perturbation::costChange(router->id(), iface.name, cost));
+            }
+    return scenario;
+}
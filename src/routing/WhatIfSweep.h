@@ -0,0 +1,69 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include "routing/RoutingEngine.h"
+#include "routing/RouteDiff.h"
+
+class Network;
+
+// One change to the base network
+struct Perturbation {
+    enum class Kind { LinkDown, CostChange, RouterDown };
+
+    Kind    kind = Kind::LinkDown;
+    QString id;            // link id for LinkDown, router id otherwise
+    QString interfaceName; // CostChange: interface on the router
+    int     cost = 0;      // CostChange: new OSPF cost
+
+    static Perturbation linkDown(const QString &linkId);
+    static Perturbation costChange(const QString &routerId, const QString &interfaceName, int cost);
+    static Perturbation routerDown(const QString &routerId);
+
+    QString describe() const;
+};
+
+struct WhatIfScenario {
+    QString             name;
+    QList<Perturbation> changes; // applied together
+};
+
+struct WhatIfOutcome {
+    QString         scenario;
+    RouteDiffResult diff;        // against the baseline
+    int             spfRuns = 0; // SPF roots recomputed; the others kept their baseline tree
+    QStringList     errors;      // changes naming an unknown link, router or interface
+};
+
+struct WhatIfResult {
+    SimulationResult     baseline;
+    QList<WhatIfOutcome> outcomes; // in scenario order
+};
+
+// ---------------------------------------------------------------------------
+// WhatIfSweep
+//
+// Evaluates many perturbations of one network without touching it.  The
+// network is snapshotted into a DeviceStore; each worker thread builds its own
+// copy, starts from the baseline tables (shared, not copied) and, per
+// scenario, applies the changes, recomputes only what they can affect, diffs
+// the affected routers against the baseline and undoes the changes.
+//
+// What is recomputed: an OSPF or PIM-DM root only if its baseline SPF tree
+// uses a failed link or one whose cost rose (any cost decrease recomputes the
+// whole domain); every RIPv2 router if a RIPv2 adjacency changed; static
+// routes never, since they do not depend on links.  A failed router loses its
+// links and all of its routes.  Unicast only: no multicast trees are built.
+// ---------------------------------------------------------------------------
+class WhatIfSweep
+{
+public:
+    static WhatIfResult run(const Network *base, const QList<WhatIfScenario> &scenarios);
+
+    // N-1 scenario lists: every link, or every router, failing on its own
+    static QList<WhatIfScenario> linkFailures(const Network *network);
+    static QList<WhatIfScenario> routerFailures(const Network *network);
+
+    // Every OSPF and PIM-DM interface cost multiplied by 'factor' (at least 1)
+    static WhatIfScenario scaledCosts(const Network *network, double factor);
+};
@@ -5,12 +5,30 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtConcurrentMap>
 #include <iostream>
 #include <functional>
+#include <cmath>
 
 #include "models/Network.h"
+#include "models/DeviceStore.h"
 #include "routing/RoutingEngine.h"
 #include "validation/Validator.h"
+#include "validation/DataPlaneVerifier.h"
+#include "validation/ForwardingModel.h"
+#include "validation/ReachabilityMatrix.h"
+#include "layout/ForceLayout.h"
+#include "gui/RoutingTableModel.h"
+#include "routing/RouteDiff.h"
+#include "routing/WhatIfSweep.h"
+#include "utils/IpUtils.h"
+#include "utils/PrefixTrie.h"
+#include "utils/ScratchArena.h"
+#include "utils/StringPool.h"
+#include "utils/Trace.h"
 
 // ---------------------------------------------------------------------------
 // Tiny test harness
@@ -71,31 +89,31 @@ static Network *buildRipNetwork(QObject *parent)
 
     auto *r1 = new Router("R1", net);
     r1->setRoutingProtocol(Router::RoutingProtocol::RIPv2);
-    r1->interfaces()[0].ipAddress  = "10.0.0.1";
-    r1->interfaces()[0].subnetMask = "255.255.255.252";
-    r1->interfaces()[1].ipAddress  = "192.168.1.1";
-    r1->interfaces()[1].subnetMask = "255.255.255.0";
+    r1->interfaces()[0].setIpAddress("10.0.0.1");
+    r1->interfaces()[0].setSubnetMask("255.255.255.252");
+    r1->interfaces()[1].setIpAddress("192.168.1.1");
+    r1->interfaces()[1].setSubnetMask("255.255.255.0");
     r1->setPosition(100, 200);
     net->addDevice(r1);
 
     auto *r2 = new Router("R2", net);
     r2->setRoutingProtocol(Router::RoutingProtocol::RIPv2);
-    r2->interfaces()[0].ipAddress  = "10.0.0.2";
-    r2->interfaces()[0].subnetMask = "255.255.255.252";
-    r2->interfaces()[1].ipAddress  = "172.16.0.1";
-    r2->interfaces()[1].subnetMask = "255.255.255.0";
+    r2->interfaces()[0].setIpAddress("10.0.0.2");
+    r2->interfaces()[0].setSubnetMask("255.255.255.252");
+    r2->interfaces()[1].setIpAddress("172.16.0.1");
+    r2->interfaces()[1].setSubnetMask("255.255.255.0");
     r2->setPosition(300, 200);
     net->addDevice(r2);
 
     auto *pc1 = new PC("PC1", net);
-    pc1->interfaces()[0].ipAddress  = "192.168.1.10";
-    pc1->interfaces()[0].subnetMask = "255.255.255.0";
+    pc1->interfaces()[0].setIpAddress("192.168.1.10");
+    pc1->interfaces()[0].setSubnetMask("255.255.255.0");
     pc1->setDefaultGateway("192.168.1.1");
     net->addDevice(pc1);
 
     auto *pc2 = new PC("PC2", net);
-    pc2->interfaces()[0].ipAddress  = "172.16.0.10";
-    pc2->interfaces()[0].subnetMask = "255.255.255.0";
+    pc2->interfaces()[0].setIpAddress("172.16.0.10");
+    pc2->interfaces()[0].setSubnetMask("255.255.255.0");
     pc2->setDefaultGateway("172.16.0.1");
     net->addDevice(pc2);
 
@@ -119,21 +137,21 @@ static Network *buildOspfNetwork(QObject *parent)
     auto *r1 = new Router("OR1", net);
     r1->setRoutingProtocol(Router::RoutingProtocol::OSPF);
     r1->ospfConfig().routerId = "1.1.1.1";
-    r1->interfaces()[0].ipAddress  = "10.1.0.1";
-    r1->interfaces()[0].subnetMask = "255.255.255.252";
+    r1->interfaces()[0].setIpAddress("10.1.0.1");
+    r1->interfaces()[0].setSubnetMask("255.255.255.252");
     r1->interfaces()[0].ospfCost   = 10;
-    r1->interfaces()[1].ipAddress  = "192.168.10.1";
-    r1->interfaces()[1].subnetMask = "255.255.255.0";
+    r1->interfaces()[1].setIpAddress("192.168.10.1");
+    r1->interfaces()[1].setSubnetMask("255.255.255.0");
     net->addDevice(r1);
 
     auto *r2 = new Router("OR2", net);
     r2->setRoutingProtocol(Router::RoutingProtocol::OSPF);
     r2->ospfConfig().routerId = "2.2.2.2";
-    r2->interfaces()[0].ipAddress  = "10.1.0.2";
-    r2->interfaces()[0].subnetMask = "255.255.255.252";
+    r2->interfaces()[0].setIpAddress("10.1.0.2");
+    r2->interfaces()[0].setSubnetMask("255.255.255.252");
     r2->interfaces()[0].ospfCost   = 10;
-    r2->interfaces()[1].ipAddress  = "172.16.10.1";
-    r2->interfaces()[1].subnetMask = "255.255.255.0";
+    r2->interfaces()[1].setIpAddress("172.16.10.1");
+    r2->interfaces()[1].setSubnetMask("255.255.255.0");
     net->addDevice(r2);
 
     net->addLink({"link-or1or2", r1->id(), "Gi0/0", r2->id(), "Gi0/0"});
@@ -150,19 +168,19 @@ static Network *buildStaticNetwork(QObject *parent)
 
     auto *r1 = new Router("SR1", net);
     r1->setRoutingProtocol(Router::RoutingProtocol::Static);
-    r1->interfaces()[0].ipAddress  = "10.0.0.1";
-    r1->interfaces()[0].subnetMask = "255.255.255.252";
-    r1->interfaces()[1].ipAddress  = "192.168.20.1";
-    r1->interfaces()[1].subnetMask = "255.255.255.0";
+    r1->interfaces()[0].setIpAddress("10.0.0.1");
+    r1->interfaces()[0].setSubnetMask("255.255.255.252");
+    r1->interfaces()[1].setIpAddress("192.168.20.1");
+    r1->interfaces()[1].setSubnetMask("255.255.255.0");
     r1->staticRoutes().append({"172.16.20.0", "255.255.255.0", "10.0.0.2", 1});
     net->addDevice(r1);
 
     auto *r2 = new Router("SR2", net);
     r2->setRoutingProtocol(Router::RoutingProtocol::Static);
-    r2->interfaces()[0].ipAddress  = "10.0.0.2";
-    r2->interfaces()[0].subnetMask = "255.255.255.252";
-    r2->interfaces()[1].ipAddress  = "172.16.20.1";
-    r2->interfaces()[1].subnetMask = "255.255.255.0";
+    r2->interfaces()[0].setIpAddress("10.0.0.2");
+    r2->interfaces()[0].setSubnetMask("255.255.255.252");
+    r2->interfaces()[1].setIpAddress("172.16.20.1");
+    r2->interfaces()[1].setSubnetMask("255.255.255.0");
     r2->staticRoutes().append({"192.168.20.0", "255.255.255.0", "10.0.0.1", 1});
     net->addDevice(r2);
 
@@ -171,6 +189,61 @@ static Network *buildStaticNetwork(QObject *parent)
     return net;
 }
 
+// ---------------------------------------------------------------------------
+// Build a three-router PIM-DM chain with a source and two receivers
+//
+//   SRC --- PR1 --- PR2 --- PR3
+//                    |       |
+//                   RXA     RXB
+// ---------------------------------------------------------------------------
+static Network *buildPimNetwork(QObject *parent)
+{
+    auto *net = new Network(parent);
+
+    auto makeRouter = [net](const QString &name) {
+        auto *r = new Router(name, net);
+        r->setRoutingProtocol(Router::RoutingProtocol::PIM_DM);
+        net->addDevice(r);
+        return r;
+    };
+    auto setIface = [](Device *d, int i, const QString &ip, const QString &mask) {
+        d->interfaces()[i].setIpAddress(ip);
+        d->interfaces()[i].setSubnetMask(mask);
+    };
+    auto makePc = [net, setIface](const QString &name, const QString &ip,
+                                  const QString &gw, const QStringList &groups) {
+        auto *pc = new PC(name, net);
+        setIface(pc, 0, ip, "255.255.255.0");
+        pc->setDefaultGateway(gw);
+        pc->setMulticastGroups(groups);
+        net->addDevice(pc);
+        return pc;
+    };
+
+    Router *r1 = makeRouter("PR1");
+    Router *r2 = makeRouter("PR2");
+    Router *r3 = makeRouter("PR3");
+    setIface(r1, 0, "10.9.0.1", "255.255.255.252");
+    setIface(r1, 1, "192.168.91.1", "255.255.255.0");
+    setIface(r2, 0, "10.9.0.2", "255.255.255.252");
+    setIface(r2, 1, "10.9.1.1", "255.255.255.252");
+    setIface(r2, 2, "192.168.92.1", "255.255.255.0");
+    setIface(r3, 0, "10.9.1.2", "255.255.255.252");
+    setIface(r3, 1, "192.168.93.1", "255.255.255.0");
+
+    PC *src = makePc("SRC", "192.168.91.10", "192.168.91.1", {});
+    PC *rxa = makePc("RXA", "192.168.92.10", "192.168.92.1", {"239.1.1.1"});
+    PC *rxb = makePc("RXB", "192.168.93.10", "192.168.93.1", {"239.1.1.2"});
+
+    net->addLink({"link-pr1pr2", r1->id(), "Gi0/0", r2->id(), "Gi0/0"});
+    net->addLink({"link-pr2pr3", r2->id(), "Gi0/1", r3->id(), "Gi0/0"});
+    net->addLink({"link-pr1src", r1->id(), "Gi0/1", src->id(), "eth0"});
+    net->addLink({"link-pr2rxa", r2->id(), "Gi0/2", rxa->id(), "eth0"});
+    net->addLink({"link-pr3rxb", r3->id(), "Gi0/1", rxb->id(), "eth0"});
+
+    return net;
+}
+
 // ---------------------------------------------------------------------------
 // Build a network with intentional validation errors
 // ---------------------------------------------------------------------------
@@ -182,23 +255,23 @@ static Network *buildBrokenNetwork(QObject *parent)
     auto *r1 = new Router("BR1", net);
     r1->setRoutingProtocol(Router::RoutingProtocol::OSPF);
     r1->ospfConfig().routerId = "3.3.3.3";
-    r1->interfaces()[0].ipAddress  = "10.0.5.1";
-    r1->interfaces()[0].subnetMask = "255.255.255.0"; // /24
+    r1->interfaces()[0].setIpAddress("10.0.5.1");
+    r1->interfaces()[0].setSubnetMask("255.255.255.0"); // /24
     net->addDevice(r1);
 
     auto *r2 = new Router("BR2", net);
     r2->setRoutingProtocol(Router::RoutingProtocol::OSPF);
     r2->ospfConfig().routerId = "3.3.3.3"; // duplicate router-id!
-    r2->interfaces()[0].ipAddress  = "10.0.5.2";
-    r2->interfaces()[0].subnetMask = "255.255.255.252"; // /30 — mismatch with BR1
+    r2->interfaces()[0].setIpAddress("10.0.5.2");
+    r2->interfaces()[0].setSubnetMask("255.255.255.252"); // /30 — mismatch with BR1
     net->addDevice(r2);
 
     net->addLink({"link-br1br2", r1->id(), "Gi0/0", r2->id(), "Gi0/0"});
 
     // PC with no gateway
     auto *pc = new PC("BPC", net);
-    pc->interfaces()[0].ipAddress  = "192.168.99.5";
-    pc->interfaces()[0].subnetMask = "255.255.255.0";
+    pc->interfaces()[0].setIpAddress("192.168.99.5");
+    pc->interfaces()[0].setSubnetMask("255.255.255.0");
     // No default gateway set
     net->addDevice(pc);  // isolated — not connected
 
@@ -208,6 +281,174 @@ static Network *buildBrokenNetwork(QObject *parent)
 // ---------------------------------------------------------------------------
 // Tests
 // ---------------------------------------------------------------------------
+static void testIpUtils()
+{
+    section("IP Parsing & Formatting");
+    using IpUtils::ParseError;
+
+    ParseError err = ParseError::Empty;
+    check(IpUtils::parse(u"192.168.1.10", &err) == 0xC0A8010Au && err == ParseError::None,
+          "Dotted quad parses");
+    check(IpUtils::parse(u"0.0.0.0", &err) == 0 && err == ParseError::None,
+          "0.0.0.0 is not an error");
+    check(IpUtils::parse(u"010.001.000.009") == 0x0A010009u, "Leading zeros are accepted");
+
+    const QList<QPair<QString, ParseError>> bad = {
+        {"",                ParseError::Empty},
+        {"10.0.0.x",        ParseError::InvalidCharacter},
+        {" 10.0.0.1",       ParseError::InvalidCharacter},
+        {"10..0.1",         ParseError::EmptyOctet},
+        {"10.0.0.",         ParseError::EmptyOctet},
+        {"10.0.256.1",      ParseError::OctetOutOfRange},
+        {"10.0.0001.1",     ParseError::OctetOutOfRange},
+        {"10.0.1",          ParseError::TooFewOctets},
+        {"10.0.0.1.2",      ParseError::TooManyOctets},
+    };
+    bool allDistinct = true;
+    for (const auto &[text, expected] : bad)
+        allDistinct = allDistinct && IpUtils::parse(text, &err) == 0 && err == expected;
+    check(allDistinct, "Malformed addresses report the specific error");
+    check(!IpUtils::isValidIp(u"1.2.3") && IpUtils::isValidMask(u"255.255.254.0") &&
+          !IpUtils::isValidMask(u"255.0.255.0"), "Validity checks use the strict parser");
+
+    bool roundTrip = true;
+    for (quint32 ip : {0u, 1u, 9u, 10u, 99u, 100u, 255u, 0x0A000001u, 0x64400A05u,
+                       0xC0A80164u, 0xFFFFFFFFu})
+        roundTrip = roundTrip && IpUtils::parse(IpUtils::format(ip)) == ip;
+    check(roundTrip && IpUtils::format(0xFFFFFFFFu) == "255.255.255.255" &&
+          IpUtils::format(0x0A000001u) == "10.0.0.1", "Formatting round-trips");
+
+    char buffer[IpUtils::FORMAT_BUFFER_SIZE];
+    const int len = IpUtils::formatTo(0xC0A8010Au, buffer);
+    check(QByteArray(buffer, len) == "192.168.1.10", "formatTo writes into a caller buffer");
+
+    qsizetype failures = -1;
+    const QList<quint32> column = IpUtils::parseAll({"10.0.0.1", "bogus", "172.16.0.1"}, &failures);
+    check(column == QList<quint32>({0x0A000001u, 0u, 0xAC100001u}) && failures == 1,
+          "Batch parsing reports failures and zero-fills them");
+}
+
+static void testInterfaceAddress()
+{
+    section("Interface Addresses");
+
+    NetworkInterface iface;
+    iface.name = "Gi0/0";
+    check(!iface.isConfigured() && iface.ipAddress().isEmpty(), "New interfaces are unset");
+
+    check(iface.setIpAddress("10.1.2.3") && iface.setSubnetMask("255.255.255.0"),
+          "Valid strings are accepted");
+    check(iface.isConfigured() && iface.ipAsUint32() == 0x0A010203u &&
+          iface.networkAddr() == 0x0A010200u && iface.prefixLen() == 24,
+          "Parsed address, network and prefix are kept");
+
+    check(!iface.setSubnetMask("255.255.0") && !iface.isConfigured() && iface.hasIpAddress(),
+          "A malformed mask is rejected and leaves the mask unset");
+    check(iface.setIpAddress("") && !iface.hasIpAddress(), "An empty string clears the address");
+
+    iface.setAddress(0xC0A80001u, 0xFFFFFFFCu);
+    const NetworkInterface copy = NetworkInterface::fromJson(iface.toJson());
+    check(copy.ipAddress() == "192.168.0.1" && copy.subnetMask() == "255.255.255.252" &&
+          copy.prefixLen() == 30, "JSON round-trips through the display strings");
+}
+
+static void testIpv6()
+{
+    section("IPv6");
+    using IpUtils::ParseError;
+
+    ParseError err;
+    check(IpUtils::format6(IpUtils::parse6(u"2001:DB8:0:0:0:0:0:1", &err)) == "2001:db8::1" &&
+          err == ParseError::None, "Addresses format in RFC 5952 form");
+    check(IpUtils::format6(IpUtils::parse6(u"::")) == "::" &&
+          IpUtils::format6(IpUtils::parse6(u"fe80::")) == "fe80::" &&
+          IpUtils::format6(IpUtils::parse6(u"1:0:0:2:0:0:0:3")) == "1:0:0:2::3",
+          "The longest zero run is the one compressed");
+    check(IpUtils::parse6(u"::ffff:10.1.2.3") == IpUtils::Ip6Address{0, 0xFFFF0A010203ull},
+          "A trailing dotted quad fills the last two groups");
+
+    IpUtils::parse6(u"1::2::3", &err);
+    check(err == ParseError::InvalidCompression, "Two '::' are rejected");
+    IpUtils::parse6(u"1:2:3:4:5:6:7", &err);
+    check(err == ParseError::TooFewOctets, "Seven groups without '::' are rejected");
+    IpUtils::parse6(u"12345::", &err);
+    check(err == ParseError::OctetOutOfRange, "Five-digit groups are rejected");
+    IpUtils::Ip6Address a;
+    int len = 0;
+    check(IpUtils::parseCidr6(u"2001:db8::1/64", &a, &len) && len == 64 &&
+          !IpUtils::parseCidr6(u"2001:db8::1/129", &a, &len, &err) &&
+          err == ParseError::InvalidPrefix, "CIDR text needs a length of 0-128");
+
+    // Longest-prefix match
+    PrefixTrie trie;
+    trie.insert(IpUtils::parse6(u"2001:db8::"),   32, 1);
+    trie.insert(IpUtils::parse6(u"2001:db8:1::"), 48, 2);
+    trie.insert(IpUtils::parse6(u"2001:db8:1::"), 48, 9); // duplicate: first one wins
+    trie.insert(IpUtils::parse6(u"2001:db8:8000::"), 33, 3);
+    check(trie.lookup(IpUtils::parse6(u"2001:db8:1::5")) == 2 &&
+          trie.lookup(IpUtils::parse6(u"2001:db8:2::5")) == 1 &&
+          trie.lookup(IpUtils::parse6(u"2001:db8:ffff::1")) == 3,
+          "The trie returns the longest matching prefix");
+    check(trie.lookup(IpUtils::parse6(u"fe80::1")) == -1, "No match without a default route");
+    trie.insert(IpUtils::Ip6Address{}, 0, 0);
+    check(trie.lookup(IpUtils::parse6(u"fe80::1")) == 0, "The default route catches the rest");
+
+    PrefixTrie trie4;
+    trie4.insert4(0x0A000000u, 8, 1);
+    trie4.insert4(0x0A100000u, 12, 2);
+    check(trie4.lookup4(0x0A1F0001u) == 2 && trie4.lookup4(0x0A200001u) == 1 &&
+          trie4.lookup4(0x0B000001u) == -1, "IPv4 prefixes match through the same trie");
+
+    // Dual-stack OSPF: one SPF, OSPFv3 routes with IPv6 next hops
+    QObject owner;
+    Network *ospf = buildOspfNetwork(&owner);
+    Router *or1 = ospf->routers().value(0), *or2 = ospf->routers().value(1);
+    if (or1->name() != "OR1") std::swap(or1, or2);
+    or1->interfaces()[0].setIpv6Address("2001:db8::1/64");
+    or1->interfaces()[1].setIpv6Address("2001:db8:10::1/64");
+    or2->interfaces()[0].setIpv6Address("2001:db8::2/64");
+    or2->interfaces()[1].setIpv6Address("2001:db8:20::1/64");
+    const SimulationResult before = RoutingEngine::run(ospf);
+
+    check(hasRoute(or1->computedRoutingTable(), "2001:db8:10::", "/64", "Connected"),
+          "OR1 has a connected IPv6 route");
+    bool v3 = false;
+    for (const auto &e : or1->computedRoutingTable())
+        if (e.destination == "2001:db8:20::" && e.mask == "/64" && e.protocol == "OSPFv3")
+            v3 = e.nextHop == "2001:db8::2" && e.exitInterface == "Gi0/0" && e.metric == 10;
+    check(v3, "OR1 learned 2001:db8:20::/64 via OSPFv3 through OR2's IPv6 address");
+    check(hasRoute(or1->computedRoutingTable(), "172.16.10.0", "255.255.255.0", "OSPF"),
+          "IPv4 routes are unaffected");
+
+    or2->interfaces()[1].setIpv6Address("2001:db8:30::1/64");
+    const RouteDiffResult diff = RouteDiff::compute(before, RoutingEngine::run(ospf));
+    check(diff.added == 2 && diff.removed == 2 && diff.nextHopChanged == 0,
+          "Route diff tracks IPv6 prefixes");
+
+    or2->interfaces()[0].setIpv6Address("2001:db9::2/64");
+    bool mismatch = false;
+    for (const auto &issue : Validator::validate(ospf))
+        mismatch = mismatch || issue.message.startsWith("IPv6 prefix mismatch");
+    check(mismatch, "Validator flags a link with different IPv6 prefixes");
+
+    // Static IPv6 route: normalised, with the exit interface resolved
+    Network *st = buildStaticNetwork(&owner);
+    Router *sr1 = st->routers().value(0);
+    if (sr1->name() != "SR1") sr1 = st->routers().value(1);
+    sr1->interfaces()[0].setIpv6Address("2001:db8::1/64");
+    sr1->staticRoutes().append({"2001:db8:99::1", "64", "2001:db8::2", 1});
+    RoutingEngine::run(st);
+    bool resolved = false;
+    for (const auto &e : sr1->computedRoutingTable())
+        if (e.protocol == "Static" && e.isIpv6())
+            resolved = e.destination == "2001:db8:99::" && e.mask == "/64" &&
+                       e.exitInterface == "Gi0/0";
+    check(resolved, "IPv6 static routes resolve their exit interface");
+
+    const NetworkInterface copy = NetworkInterface::fromJson(sr1->interfaces()[0].toJson());
+    check(copy.ipv6Address() == "2001:db8::1/64", "IPv6 addresses round-trip through JSON");
+}
+
 static void testRipv2()
 {
     section("RIPv2 Simulation");
@@ -310,6 +551,132 @@ static void testStatic()
     check(correctNextHop, "SR1 static route next-hop is 10.0.0.2");
 }
 
+static bool treeHasRouter(const MulticastTree &tree, const QString &name)
+{
+    for (const auto &e : tree.entries)
+        if (e.routerName == name) return true;
+    return false;
+}
+
+static void testPimBatch()
+{
+    section("PIM-DM Batch Trees");
+    QObject owner;
+    Network *net = buildPimNetwork(&owner);
+
+    const QList<MulticastFlow> flows = {
+        {"192.168.91.10", "239.1.1.1"},
+        {"192.168.91.10", "239.1.1.2"},
+        {"192.168.91.10", "239.1.1.3"},
+    };
+    const SimulationResult result = RoutingEngine::run(net, flows);
+
+    check(result.multicastTrees.size() == 3, "One tree per (source, group) flow");
+    if (result.multicastTrees.size() != 3) return;
+
+    const MulticastTree &g1 = result.multicastTrees[0];
+    const MulticastTree &g2 = result.multicastTrees[1];
+    const MulticastTree &g3 = result.multicastTrees[2];
+    check(g1.groupAddress == "239.1.1.1" && g2.groupAddress == "239.1.1.2",
+          "Trees are returned in flow order");
+    check(treeHasRouter(g1, "PR2") && !treeHasRouter(g1, "PR3") && g1.pruned.contains("PR3"),
+          "239.1.1.1 reaches RXA on PR2 and prunes PR3");
+    check(treeHasRouter(g2, "PR2") && treeHasRouter(g2, "PR3"),
+          "239.1.1.2 is forwarded through PR2 to RXB on PR3");
+    check(g3.entries.size() == 1 && treeHasRouter(g3, "PR1"),
+          "A group without members keeps only the first-hop router");
+}
+
+static void testPimRpf()
+{
+    section("PIM-DM RPF Interfaces");
+    QObject owner;
+    Network *net = buildPimNetwork(&owner);
+
+    // Direct PR1-PR3 link that a hop-count flood would prefer, but whose
+    // cost makes the unicast route to the source go through PR2
+    Router *r1 = nullptr, *r3 = nullptr;
+    for (auto *r : net->routers()) {
+        if (r->name() == "PR1") r1 = r;
+        if (r->name() == "PR3") r3 = r;
+    }
+    r1->interfaces()[2].setIpAddress("10.9.2.1");
+    r1->interfaces()[2].setSubnetMask("255.255.255.252");
+    r1->interfaces()[2].ospfCost   = 100;
+    r3->interfaces()[2].setIpAddress("10.9.2.2");
+    r3->interfaces()[2].setSubnetMask("255.255.255.252");
+    r3->interfaces()[2].ospfCost   = 100;
+    net->addLink({"link-pr1pr3", r1->id(), "Gi0/2", r3->id(), "Gi0/2"});
+
+    const SimulationResult result = RoutingEngine::run(net, {{"192.168.91.10", "239.1.1.2"}});
+    check(result.multicastTrees.size() == 1, "One tree for the single flow");
+    if (result.multicastTrees.isEmpty()) return;
+
+    const MulticastTree &tree = result.multicastTrees.first();
+    QString pr3In;
+    QStringList pr1Out, pr2Out;
+    for (const auto &e : tree.entries) {
+        if (e.routerName == "PR1") pr1Out = e.outgoingInterfaces;
+        if (e.routerName == "PR2") pr2Out = e.outgoingInterfaces;
+        if (e.routerName == "PR3") pr3In  = e.incomingInterface;
+    }
+    check(pr3In == "Gi0/0", "PR3 accepts the source on its RPF interface toward PR2");
+    check(pr1Out == QStringList{"Gi0/0"}, "PR1 forwards only toward PR2, not on the costly link");
+    check(pr2Out.contains("Gi0/1"), "PR2 forwards the group on to PR3");
+}
+
+// A receiver on the LAN a router's RPF interface faces is fed by the
+// first-hop router, never by forwarding back out of the incoming interface
+static void testPimUpstreamReceiver()
+{
+    section("PIM-DM Receiver Upstream");
+    QObject owner;
+    Network *net = buildPimNetwork(&owner);
+
+    Router *r1 = nullptr, *r3 = nullptr;
+    PC *src = nullptr;
+    for (auto *r : net->routers()) {
+        if (r->name() == "PR1") r1 = r;
+        if (r->name() == "PR3") r3 = r;
+    }
+    for (auto *pc : net->pcs())
+        if (pc->name() == "SRC") src = pc;
+
+    // The source LAN becomes a switch shared by PR1, PR3 and a receiver, so
+    // PR3's RPF interface toward the source faces that receiver
+    r3->setInterfaceAddress("Gi0/2", IpUtils::parse(u"192.168.91.3"), 0xFFFFFF00u);
+    auto *sw = new Switch("SWS", net);
+    net->addDevice(sw);
+    auto *rxu = new PC("RXU", net);
+    rxu->interfaces()[0].setIpAddress("192.168.91.20");
+    rxu->interfaces()[0].setSubnetMask("255.255.255.0");
+    rxu->setDefaultGateway("192.168.91.1");
+    rxu->setMulticastGroups({"239.1.1.1"});
+    net->addDevice(rxu);
+
+    net->removeLink("link-pr1src");
+    net->addLink({"link-sws-a", r1->id(), "Gi0/1", sw->id(), "Fa0/0"}); // first-hop router
+    net->addLink({"link-sws-b", r3->id(), "Gi0/2", sw->id(), "Fa0/1"});
+    net->addLink({"link-sws-c", src->id(), "eth0", sw->id(), "Fa0/2"});
+    net->addLink({"link-sws-d", rxu->id(), "eth0", sw->id(), "Fa0/3"});
+
+    const SimulationResult result = RoutingEngine::run(net, {{"192.168.91.10", "239.1.1.1"}});
+    check(result.multicastTrees.size() == 1, "One tree for the single flow");
+    if (result.multicastTrees.isEmpty()) return;
+
+    bool backOut = false;
+    QStringList pr1Out, pr3Out;
+    for (const auto &e : result.multicastTrees.first().entries) {
+        backOut = backOut || (!e.incomingInterface.isEmpty() &&
+                              e.outgoingInterfaces.contains(e.incomingInterface));
+        if (e.routerName == "PR1") pr1Out = e.outgoingInterfaces;
+        if (e.routerName == "PR3") pr3Out = e.outgoingInterfaces;
+    }
+    check(!backOut, "No router lists its incoming interface as outgoing");
+    check(pr1Out.contains("Gi0/1"), "The first-hop router serves the receiver on the source LAN");
+    check(!pr3Out.contains("Gi0/2"), "PR3 does not forward back onto the source LAN");
+}
+
 static void testValidationClean()
 {
     section("Validation — Clean Network");
@@ -348,6 +715,127 @@ static void testValidationErrors()
           "Detected isolated device (BPC)");
 }
 
+static bool hasForwardingIssue(const DataPlaneReport &report,
+                               ForwardingIssue::Kind kind,
+                               const QString &destination)
+{
+    for (const auto &i : report.issues)
+        if (i.kind == kind && i.destination == destination)
+            return true;
+    return false;
+}
+
+static void testDataPlane()
+{
+    section("Data-Plane Verification");
+    QObject owner;
+    Network *net = buildStaticNetwork(&owner);
+    RoutingEngine::run(net);
+
+    const DataPlaneReport clean = DataPlaneVerifier::verify(net);
+    check(clean.issues.isEmpty(), "No forwarding issues on the static chain");
+    check(clean.pairsChecked == 6, "Every (router, prefix) pair with a route is checked");
+
+    Router *r1 = nullptr, *r2 = nullptr;
+    for (auto *r : net->routers()) {
+        if (r->name() == "SR1") r1 = r;
+        if (r->name() == "SR2") r2 = r;
+    }
+    r1->staticRoutes().append({"8.8.8.0", "255.255.255.0", "10.0.0.2", 1}); // loop with SR2
+    r2->staticRoutes().append({"8.8.8.0", "255.255.255.0", "10.0.0.1", 1});
+    r1->staticRoutes().append({"7.7.7.0", "255.255.255.0", "10.0.0.2", 1}); // SR2 has no route
+    r1->staticRoutes().append({"9.9.9.0", "255.255.255.0", "10.0.0.3", 1}); // nobody owns .3
+    RoutingEngine::run(net);
+
+    const DataPlaneReport report = DataPlaneVerifier::verify(net);
+    for (const auto &i : report.issues)
+        std::cout << "    [" << i.kindString().toStdString() << "] "
+                  << i.message.toStdString() << "\n";
+
+    check(hasForwardingIssue(report, ForwardingIssue::Kind::Loop, "8.8.8.0/24"),
+          "Detected forwarding loop for 8.8.8.0/24");
+    check(hasForwardingIssue(report, ForwardingIssue::Kind::BlackHole, "7.7.7.0/24"),
+          "Detected black hole for 7.7.7.0/24 at SR2");
+    check(hasForwardingIssue(report, ForwardingIssue::Kind::DeadNextHop, "9.9.9.0/24"),
+          "Detected dead next hop 10.0.0.3 for 9.9.9.0/24");
+
+    bool loopWitness = false;
+    for (const auto &i : report.issues)
+        if (i.kind == ForwardingIssue::Kind::Loop && i.affectedRouters == 2 &&
+            i.path.size() == 3 && i.path.first() == i.path.last())
+            loopWitness = true;
+    check(loopWitness, "Loop witness path closes the cycle and covers both routers");
+
+    // The FIB runs agree with a direct longest-prefix match for every class
+    const ForwardingModel model(net);
+    bool lpmAgrees = true;
+    for (int r = 0; r < model.routerCount(); ++r) {
+        const auto &table = model.router(r)->computedRoutingTable();
+        for (int ec = 0; ec < model.classes().size(); ++ec) {
+            const quint32 at = model.classes()[ec].first;
+            int best = -1, bestLen = -1;
+            for (int i = 0; i < table.size(); ++i) {
+                if (table[i].isIpv6()) continue;
+                const int     len  = IpUtils::maskToPrefix(IpUtils::parse(table[i].mask));
+                const quint32 mask = IpUtils::prefixToMask(len);
+                if ((at & mask) == (IpUtils::parse(table[i].destination) & mask) && len > bestLen) {
+                    best    = i;
+                    bestLen = len;
+                }
+            }
+            lpmAgrees = lpmAgrees && model.fibEntry(r, ec) == best;
+        }
+    }
+    check(model.classes().size() > 3 && lpmAgrees, "FIB runs match a per-class longest-prefix match");
+}
+
+static void testReachabilityMatrix()
+{
+    section("PC Reachability Matrix");
+    QObject owner;
+    Network *net = buildRipNetwork(&owner);
+    RoutingEngine::run(net);
+
+    const ReachabilityMatrix before = ReachabilityMatrix::compute(net);
+    PC *pc1 = nullptr, *pc2 = nullptr;
+    for (auto *pc : net->pcs()) {
+        if (pc->name() == "PC1") pc1 = pc;
+        if (pc->name() == "PC2") pc2 = pc;
+    }
+    const int i1 = before.indexOf(pc1->id());
+    const int i2 = before.indexOf(pc2->id());
+
+    check(before.size() == 2, "Matrix has one row per PC");
+    check(before.reachable(i1, i2), "PC1 reaches PC2 through R1 -> R2");
+    check(before.reachable(i2, i1), "PC2 reaches PC1 through R2 -> R1");
+    check(before.reachablePairs() == 4, "All four PC pairs are reachable");
+
+    const QString path = QCoreApplication::applicationDirPath() + "/test_matrix.reach";
+    QString err;
+    ReachabilityMatrix loaded;
+    check(before.save(path, &err) && loaded.load(path, &err), "Matrix exports and re-imports");
+    const ReachabilityDiff same = ReachabilityMatrix::diff(before, loaded);
+    check(same.gained == 0 && same.lost == 0, "Re-imported matrix is identical");
+    QFile::remove(path);
+
+    pc2->setDefaultGateway("172.16.0.99"); // no router owns this address
+    const ReachabilityMatrix after = ReachabilityMatrix::compute(net);
+    check(!after.reachable(i2, i1), "PC2 loses PC1 with a wrong gateway");
+    check(after.reachable(i1, i2), "PC1 still reaches PC2");
+
+    const ReachabilityDiff d = ReachabilityMatrix::diff(before, after);
+    check(d.lost == 1 && d.gained == 0 && d.lostPairs.first().first == "PC2",
+          "Diff reports exactly the lost PC2 -> PC1 pair");
+
+    net->removeDevice(pc1->id());
+    auto *pc3 = new PC("PC3");
+    net->addDevice(pc3);
+    const ReachabilityDiff moved = ReachabilityMatrix::diff(after, ReachabilityMatrix::compute(net));
+    check(moved.removedPcs == QStringList{"PC1"} && moved.addedPcs == QStringList{"PC3"} &&
+          moved.gained == 0 && moved.lost == 0,
+          "Diff lists PCs present in only one matrix");
+}
+
 static void testSaveLoad()
 {
     section("Save / Load");
@@ -380,6 +868,610 @@ static void testSaveLoad()
     QFile::remove(path);
 }
 
+static void testDeviceStore()
+{
+    section("Device Store");
+    QObject owner;
+    Network *net = buildPimNetwork(&owner);
+    const DeviceStore store = DeviceStore::fromNetwork(net);
+
+    check(store.deviceCount() == net->devices().size() &&
+          store.count(Device::Type::Router) == net->routers().size() &&
+          store.count(Device::Type::PC) == net->pcs().size() &&
+          store.linkCount() == net->links().size(), "Every device and link gets a row");
+
+    Router *pr2 = nullptr;
+    for (auto *r : net->routers())
+        if (r->name() == "PR2") pr2 = r;
+    const DeviceHandle h = store.find(pr2->id());
+    check(h.isValid() && h.type() == Device::Type::Router && store.name(h) == "PR2" &&
+          store.routingProtocol(h) == Router::RoutingProtocol::PIM_DM,
+          "Handles carry the device type and address its columns");
+    check(!store.find("no-such-device").isValid(), "Unknown ids give an invalid handle");
+
+    const int row = store.findInterface(h, "Gi0/1");
+    check(row >= 0 && store.interfaceOwner(row) == h && store.interfaceConfigured(row) &&
+          store.interfaceIp(row) == pr2->getInterface("Gi0/1")->ipAsUint32(),
+          "Interface rows hold the parsed address");
+    check(store.neighbors(h).size() == net->linksForDevice(pr2->id()).size() &&
+          store.interfaceOwner(store.linkEnd1(store.interfaceLink(row))) == h,
+          "Links connect interface rows");
+
+    // Store -> file -> Network, and Network -> store -> Network, route the same
+    const QString path = QCoreApplication::applicationDirPath() + "/test_store.net";
+    QString err;
+    check(store.save(path, &err), "The store saves in the network file format");
+    auto *loaded = new Network(&owner);
+    check(loaded->load(path, &err), "Network loads a file saved by the store");
+    auto *facade = new Network(&owner);
+    store.toNetwork(facade);
+
+    const SimulationResult base = RoutingEngine::run(net);
+    check(RouteDiff::compute(base, RoutingEngine::run(loaded)).isEmpty() &&
+          RouteDiff::compute(base, RoutingEngine::run(facade)).isEmpty(),
+          "Rebuilt networks compute identical routes");
+
+    DeviceStore reloaded;
+    check(reloaded.load(path, &err) && reloaded.deviceCount() == store.deviceCount() &&
+          reloaded.linkCount() == store.linkCount() &&
+          reloaded.toJson() == store.toJson(), "The store loads its own file losslessly");
+    QFile::remove(path);
+}
+
+static void testChangeSignals()
+{
+    section("Network Change Signals");
+    QObject owner;
+    Network *net = buildRipNetwork(&owner);
+
+    QStringList events;
+    QObject::connect(net, &Network::deviceAdded,   [&](const QString &) { events << "deviceAdded"; });
+    QObject::connect(net, &Network::deviceRemoved, [&](const QString &id) {
+        // Still present while listeners run
+        events << (net->device(id) ? "deviceRemoved" : "deviceRemoved(gone)");
+    });
+    QObject::connect(net, &Network::deviceChanged, [&](const QString &) { events << "deviceChanged"; });
+    QObject::connect(net, &Network::linkAdded,     [&](const QString &) { events << "linkAdded"; });
+    QObject::connect(net, &Network::linkRemoved,   [&](const QString &) { events << "linkRemoved"; });
+    QObject::connect(net, &Network::reset,         [&]() { events << "reset"; });
+
+    Router *r1 = nullptr;
+    for (auto *r : net->routers())
+        if (r->name() == "R1") r1 = r;
+    const int r1Links = static_cast<int>(net->linksForDevice(r1->id()).size());
+
+    net->notifyDeviceChanged(r1->id());
+    check(events == QStringList{"deviceChanged"}, "Editing a device emits only deviceChanged");
+
+    events.clear();
+    net->removeDevice(r1->id());
+    QStringList expected;
+    for (int i = 0; i < r1Links; ++i) expected << "linkRemoved";
+    expected << "deviceRemoved";
+    check(events == expected, "Removing a device reports its links, then the device");
+
+    const QString path = QCoreApplication::applicationDirPath() + "/test_signals.net";
+    QString err;
+    net->save(path, &err);
+    events.clear();
+    net->load(path, &err);
+    check(events == QStringList{"reset"}, "Loading emits a single reset and no per-item events");
+    QFile::remove(path);
+}
+
+static void testDeviceLists()
+{
+    section("Per-Type Device Lists");
+    QObject owner;
+    Network *net = buildPimNetwork(&owner);
+
+    QStringList names;
+    for (auto *r : net->routers()) names << r->name();
+    check(names == QStringList({"PR1", "PR2", "PR3"}), "Routers are listed in insertion order");
+    check(net->pcs().size() == 3 && net->switches().isEmpty() && net->hubs().isEmpty(),
+          "PCs, switches and hubs have their own lists");
+    check(net->routers(Router::RoutingProtocol::PIM_DM).size() == 3 &&
+          net->routers(Router::RoutingProtocol::OSPF).isEmpty(), "Routers are grouped by protocol");
+
+    Router *pr2 = net->routers()[1];
+    pr2->setRoutingProtocol(Router::RoutingProtocol::OSPF);
+    check(net->routers(Router::RoutingProtocol::PIM_DM).size() == 2 &&
+          net->routers(Router::RoutingProtocol::OSPF) == QList<Router *>{pr2},
+          "A protocol change moves the router between lists");
+
+    net->addDevice(new Switch("SW1"));
+    net->removeDevice(pr2->id());
+    check(net->switches().size() == 1 && net->routers().size() == 2 &&
+          net->routers(Router::RoutingProtocol::OSPF).isEmpty(), "Lists follow adds and removals");
+
+    Router *pr1 = net->routers()[0];
+    Device *sw1 = net->switches()[0];
+    net->addLink({"L-z", pr1->id(), "Gi0/3", sw1->id(), "Fa0/1"});
+    net->addLink({"L-a", sw1->id(), "Fa0/2", pr1->id(), "Gi0/2"});
+    QStringList swLinks;
+    for (const Link *l : net->linksForDevice(sw1->id())) swLinks << l->id;
+    net->removeLink("L-z");
+    check(swLinks == QStringList({"L-a", "L-z"}) && net->linksForDevice(sw1->id()).size() == 1 &&
+          !net->interfaceInUse(pr1->id(), "Gi0/3") && net->interfaceInUse(pr1->id(), "Gi0/2"),
+          "Per-device links stay ordered by id across adds and removals");
+
+    const QString path = QCoreApplication::applicationDirPath() + "/test_lists.net";
+    QString err;
+    net->save(path, &err);
+    net->load(path, &err);
+    check(net->routers().size() == 2 && net->pcs().size() == 3 && net->switches().size() == 1,
+          "Lists are rebuilt on load");
+    QFile::remove(path);
+}
+
+static void testAddressIndex()
+{
+    section("Address Index");
+    QObject owner;
+    Network *net = buildPimNetwork(&owner);
+    const quint32 rxaIp = IpUtils::parse(u"192.168.92.10");
+
+    const Network::InterfaceRef ref = net->addressOwner(rxaIp);
+    check(ref.isValid() && ref.device->name() == "RXA" && ref.iface().name == "eth0",
+          "An address resolves to its device and interface");
+    check(!net->addressOwner(IpUtils::parse(u"192.168.92.99")).isValid(),
+          "Unused addresses have no owner");
+    check(net->conflictingAddresses().isEmpty(), "A clean network has no conflicts");
+
+    auto *dup = new PC("DUP");
+    dup->interfaces()[0].setIpAddress("192.168.92.10");
+    net->addDevice(dup);
+    check(net->conflictingAddresses() == QList<quint32>{rxaIp} &&
+          net->addressOwners(rxaIp).size() == 2, "A second owner is tracked as a conflict");
+    bool reported = false;
+    for (const auto &issue : Validator::validate(net))
+        reported = reported || issue.message.startsWith("IP address conflict: 192.168.92.10");
+    check(reported, "The validator reports the conflict from the index");
+
+    Device *rxa = ref.device;
+    rxa->interfaces()[0].setIpAddress("192.168.92.11");
+    net->notifyDeviceChanged(rxa->id());
+    check(net->conflictingAddresses().isEmpty() && net->addressOwner(rxaIp).device == dup &&
+          net->addressOwner(IpUtils::parse(u"192.168.92.11")).device == rxa,
+          "Editing an interface re-indexes the device");
+
+    auto *late = new Router("LATE");
+    net->addDevice(late);
+    const quint32 lateIp = IpUtils::parse(u"10.99.0.1");
+    check(late->setInterfaceAddress("Gi0/1", lateIp, 0xFFFFFFFCu) &&
+          net->addressOwner(lateIp).device == late &&
+          net->addressOwner(lateIp).iface().name == "Gi0/1",
+          "Addresses set after adding a device are indexed without a notify");
+    check(!late->setInterfaceAddress("Gi9/9", lateIp, 0xFFFFFFFCu), "Unknown interfaces are rejected");
+
+    net->removeDevice(dup->id());
+    check(!net->addressOwner(rxaIp).isValid(), "Removing a device frees its addresses");
+}
+
+static void testStringPool()
+{
+    section("String Pool");
+    StringPool pool;
+    const Symbol a = pool.intern("Gi0/0");
+    check(a.isValid() && pool.intern(QString("Gi0/%1").arg(0)) == a && pool.intern("Gi0/1") != a,
+          "Equal text interns to the same symbol");
+    check(pool.text(a) == "Gi0/0" && pool.size() == 2, "Symbols map back to their text");
+    check(!pool.find("eth0").isValid() && pool.size() == 2, "find() does not intern");
+    check(pool.pooled(QString("Gi0/") + "0").constData() == pool.text(a).constData(),
+          "Pooled copies share one buffer");
+
+    QObject owner;
+    Network *net = buildOspfNetwork(&owner);
+    const Link *l = net->links().first();
+    const Device *d1 = net->device(l->device1Id);
+    check(l->device1Id.constData() == d1->id().constData() &&
+          l->interface1.constData() == d1->getInterface(l->interface1)->name.constData(),
+          "Links share the device's id and interface name text");
+    const Device *d2 = net->device(l->device2Id);
+    check(d1->idSymbol().isValid() && d2->idSymbol().isValid() && d1->idSymbol() != d2->idSymbol(),
+          "Devices carry their id symbol");
+    Router loose("Loose");
+    check(!loose.idSymbol().isValid(), "Ids are interned only when the device joins a network");
+    check(net->linksForDevice(d1->id()).size() == 1 && net->linksForDevice("no-such-id").isEmpty(),
+          "Link lookups by device use the per-device index");
+
+    RoutingEngine::run(net);
+    const auto &t1 = net->routers()[0]->computedRoutingTable();
+    const auto &t2 = net->routers()[1]->computedRoutingTable();
+    check(!t1.isEmpty() && !t2.isEmpty() &&
+          t1.first().protocol.constData() == t2.first().protocol.constData() &&
+          t1.first().nextHop.constData() == t2.first().nextHop.constData(),
+          "Routing tables share constant column text across routers");
+}
+
+static void testScratchArena()
+{
+    section("Scratch Arena");
+    ScratchArena arena;
+    ScratchArena::Vector<ScratchArena::Vector<int>> rows(3, arena.resource());
+    rows[1].assign(1000, 7);
+    check(rows[1].get_allocator().resource() == arena.resource() && rows[1][999] == 7,
+          "Nested scratch containers draw from the arena");
+
+    ScratchArena::Hash<const Device *, int> index(arena.resource());
+    QObject owner;
+    Network *net = buildOspfNetwork(&owner);
+    for (int i = 0; i < net->routers().size(); ++i) index.emplace(net->routers()[i], i);
+    check(int(index.size()) == net->routers().size() &&
+          index.at(net->routers().last()) == int(index.size()) - 1,
+          "Scratch hashes index devices by pointer");
+
+    // Repeated runs start from fresh scratch state and agree
+    RoutingEngine::run(net);
+    const QList<RoutingEntry> first = net->routers()[0]->computedRoutingTable();
+    RoutingEngine::run(net);
+    const QList<RoutingEntry> &second = net->routers()[0]->computedRoutingTable();
+    bool same = first.size() == second.size() && !first.isEmpty();
+    for (int i = 0; same && i < first.size(); ++i)
+        same = first[i].destination == second[i].destination && first[i].nextHop == second[i].nextHop &&
+               first[i].exitInterface == second[i].exitInterface && first[i].metric == second[i].metric;
+    check(same, "Routing runs are repeatable with per-run scratch");
+}
+
+static void testForceLayout()
+{
+    section("Auto Layout");
+    QObject owner;
+    auto *net = new Network(&owner);
+
+    // 10x10 grid of switches, all imported at the origin
+    const int side = 10;
+    QList<Switch *> grid;
+    for (int i = 0; i < side * side; ++i) {
+        grid.append(new Switch(QString("G%1").arg(i), net));
+        net->addDevice(grid.last());
+    }
+    int linkNo = 0;
+    for (int r = 0; r < side; ++r)
+        for (int c = 0; c < side; ++c) {
+            const QString id = grid[r * side + c]->id();
+            if (c + 1 < side)
+                net->addLink({QString("g%1").arg(linkNo++), id, "Fa0/0", grid[r * side + c + 1]->id(), "Fa0/1"});
+            if (r + 1 < side)
+                net->addLink({QString("g%1").arg(linkNo++), id, "Fa0/2", grid[(r + 1) * side + c]->id(), "Fa0/3"});
+        }
+
+    LayoutOptions options;
+    ForceLayout::run(net, options);
+    const qreal k = options.idealEdgeLength;
+
+    qreal minGap = 1e18;
+    for (int i = 0; i < grid.size(); ++i)
+        for (int j = i + 1; j < grid.size(); ++j)
+            minGap = std::min(minGap, std::hypot(grid[i]->x() - grid[j]->x(), grid[i]->y() - grid[j]->y()));
+    check(minGap > 0.2 * k, "No two devices are left on top of each other");
+
+    qreal edgeSum = 0;
+    for (const Link *l : net->links()) {
+        const Device *a = net->device(l->device1Id);
+        const Device *b = net->device(l->device2Id);
+        edgeSum += std::hypot(a->x() - b->x(), a->y() - b->y());
+    }
+    const qreal meanEdge = edgeSum / net->links().size();
+    check(meanEdge > 0.3 * k && meanEdge < 3 * k, "Linked devices end up about one edge length apart");
+
+    // Hierarchical: routers above the PCs they serve
+    Network *pim = buildPimNetwork(&owner);
+    options.mode = LayoutOptions::Mode::Hierarchical;
+    ForceLayout::run(pim, options);
+    qreal lowestRouter = -1e18, highestPc = 1e18;
+    for (auto *r : pim->routers()) lowestRouter = std::max(lowestRouter, r->y());
+    for (auto *pc : pim->pcs())    highestPc    = std::min(highestPc, pc->y());
+    check(lowestRouter < highestPc, "Hierarchical layout puts routers on a row above the PCs");
+
+    // Same seed, same layout, whatever order the devices were added in
+    auto *first  = new Network(&owner);
+    auto *second = new Network(&owner);
+    const int ringSize = 12;
+    QList<Switch *> ring;
+    for (int i = 0; i < ringSize; ++i) {
+        ring.append(new Switch(QString("R%1").arg(i), first));
+        first->addDevice(ring.last());
+    }
+    for (int i = 0; i < ringSize; ++i)
+        first->addLink({QString("r%1").arg(i), ring[i]->id(), "Fa0/0",
+                        ring[(i + 1) % ringSize]->id(), "Fa0/1"});
+    for (int i = ringSize - 1; i >= 0; --i)
+        second->addDevice(Switch::fromJson(ring[i]->toJson(), second));
+    const QList<const Link *> ringLinks = first->links();
+    for (auto it = ringLinks.crbegin(); it != ringLinks.crend(); ++it)
+        second->addLink(**it);
+    ForceLayout::run(first, {});
+    ForceLayout::run(second, {});
+    bool same = true;
+    for (const Switch *s : ring) {
+        const Device *t = second->device(s->id());
+        same = same && t && s->x() == t->x() && s->y() == t->y();
+    }
+    check(same, "A given seed gives the same layout regardless of insertion order");
+}
+
+static void testRoutingTableModel()
+{
+    section("Routing Table Model");
+
+    // Synthetic result: two routers, 2500 + 3 routes
+    SimulationResult result;
+    for (int r = 0; r < 2; ++r) {
+        RouterSimResult rr;
+        rr.routerName = QString("M%1").arg(r);
+        const int routes = r == 0 ? 2500 : 3;
+        for (int i = 0; i < routes; ++i) {
+            RoutingEntry e;
+            e.destination = IpUtils::format(0x0A000000u + (quint32(i) << 8));
+            e.mask        = "255.255.255.0";
+            e.metric      = i;
+            rr.routingTable.append(e);
+        }
+        result.routerResults.append(rr);
+    }
+
+    RoutingTableModel model;
+    model.setResult(result);
+    check(model.totalRoutes() == 2503 && model.rowCount() == 1000,
+          "Rows are exposed in batches rather than all at once");
+
+    while (model.canFetchMore({})) model.fetchMore({});
+    check(model.rowCount() == 2503, "fetchMore eventually exposes every route");
+    check(model.index(2500, RoutingTableModel::RouterCol).data().toString() == "M1" &&
+          model.index(2502, RoutingTableModel::MetricCol).data().toInt() == 2,
+          "Rows past a router's table map onto the next router");
+
+    model.setRouterFilter(1);
+    check(model.rowCount() == 3 && !model.canFetchMore({}) &&
+          model.index(0, RoutingTableModel::DestinationCol).data().toString() == "10.0.0.0",
+          "Router filter shows only that router's routes");
+}
+
+static void testRouteDiff()
+{
+    section("Route Diff");
+    QObject owner;
+    Network *net = buildStaticNetwork(&owner);
+
+    Router *sr1 = nullptr, *sr2 = nullptr;
+    for (auto *r : net->routers()) {
+        if (r->name() == "SR1") sr1 = r;
+        if (r->name() == "SR2") sr2 = r;
+    }
+
+    const SimulationResult before = RoutingEngine::run(net);
+    check(RouteDiff::compute(before, RoutingEngine::run(net)).isEmpty(),
+          "Re-running an unchanged network reports no changes");
+
+    sr1->staticRoutes()[0].metric = 5;                                          // metric
+    sr1->staticRoutes().append({"10.99.0.0", "255.255.0.0", "10.0.0.2", 1});     // added
+    sr2->staticRoutes()[0].nextHop = "10.0.0.3";                                // next hop
+    sr2->interfaces()[1].setIpAddress("172.16.30.1");                           // removed + added
+    const RouteDiffResult diff = RouteDiff::compute(before, RoutingEngine::run(net));
+
+    check(diff.added == 2 && diff.removed == 1, "Added and removed prefixes are counted");
+    check(diff.nextHopChanged == 1 && diff.metricChanged == 1,
+          "Next-hop and metric changes are told apart");
+    check(diff.routersChanged == 2 && diff.changes.size() == 5, "Only the deltas are listed");
+
+    bool removedLan = false;
+    for (const RouteChange &c : diff.changes)
+        if (c.kind == RouteChange::Kind::Removed && c.routerName == "SR2" &&
+            c.before.destination == "172.16.20.0")
+            removedLan = true;
+    check(removedLan, "SR2's renumbered LAN shows up as a removed route");
+}
+
+static void testSimulationStats()
+{
+    section("Simulation Statistics");
+    QObject owner;
+
+    Network *rip = buildRipNetwork(&owner);
+    const SimulationResult ripResult = RoutingEngine::run(rip);
+    const SimulationStats &s = ripResult.stats;
+
+    QStringList phases;
+    for (const PhaseTiming &p : s.phases) phases << p.name;
+    check(phases == QStringList({"Static", "RIPv2", "OSPF", "PIM-DM", "Collect"}),
+          "Every protocol phase is timed, in order");
+    check(s.ripIterations >= 2, "RIP counts passes until convergence");
+    check(s.spfRuns == 0 && s.heapOps == 0, "No SPF work without OSPF routers");
+
+    qint64 routes = 0;
+    for (const RouterSimResult &rr : ripResult.routerResults) routes += rr.routingTable.size();
+    check(s.routesInstalled == routes && routes > 0, "Installed routes match the result tables");
+    std::cout << s.summary().toStdString();
+
+    Network *ospf = buildOspfNetwork(&owner);
+    const SimulationStats os = RoutingEngine::run(ospf).stats;
+    check(os.spfRuns == 2 && os.heapOps >= 4, "OSPF counts one SPF per router and its heap operations");
+    check(os.ripIterations == 0, "No RIP passes without RIPv2 routers");
+
+    bool clean = true;
+    for (const RouterSimResult &rr : ripResult.routerResults) clean = clean && rr.warnings.isEmpty();
+    check(clean, "A consistent network produces no warnings");
+
+    rip->routers().last()->setRoutingProtocol(Router::RoutingProtocol::OSPF);
+    bool mismatch = false;
+    for (const RouterSimResult &rr : RoutingEngine::run(rip).routerResults)
+        for (const QString &w : rr.warnings)
+            if (w.contains("runs OSPF")) mismatch = true;
+    check(mismatch, "A neighbor running another protocol is reported as a warning");
+}
+
+static void testResultReuse()
+{
+    section("Result Reuse");
+    QObject owner;
+    Network *net = buildOspfNetwork(&owner);
+    Router *r1 = net->routers().first();
+
+    SimulationResult result;
+    RoutingEngine::run(net, {}, result);
+    const RoutingEntry *buffer = r1->computedRoutingTable().constData();
+    check(result.routerResults.first().routingTable.constData() == buffer,
+          "Results share the router tables instead of copying them");
+
+    const int rows = r1->computedRoutingTable().size();
+    RoutingEngine::run(net, {}, result);
+    check(r1->computedRoutingTable().constData() == buffer &&
+          r1->computedRoutingTable().size() == rows &&
+          result.routerResults.size() == net->routers().size(),
+          "Re-running into a result refills the tables in place");
+
+    const SimulationResult baseline = result;
+    r1->interfaces()[0].ospfCost = 50;
+    RoutingEngine::run(net, {}, result);
+    check(baseline.routerResults.first().routingTable.constData() == buffer &&
+          result.routerResults.first().routingTable.constData() != buffer &&
+          !RouteDiff::compute(baseline, result).isEmpty(),
+          "A held baseline keeps its rows while the next run detaches");
+}
+
+// Four OSPF routers in a ring, each with a LAN
+static Network *buildOspfRing(QObject *parent)
+{
+    auto *net = new Network(parent);
+    QList<Router *> ring;
+    for (int i = 0; i < 4; ++i) {
+        auto *r = new Router(QString("RR%1").arg(i), net);
+        r->setRoutingProtocol(Router::RoutingProtocol::OSPF);
+        r->interfaces()[2].setIpAddress(QString("192.168.%1.1").arg(50 + i));
+        r->interfaces()[2].setSubnetMask("255.255.255.0");
+        net->addDevice(r);
+        ring.append(r);
+    }
+    for (int i = 0; i < 4; ++i) {
+        Router *a = ring[i];
+        Router *b = ring[(i + 1) % 4];
+        a->interfaces()[0].setIpAddress(QString("10.9.%1.1").arg(i));
+        a->interfaces()[0].setSubnetMask("255.255.255.252");
+        b->interfaces()[1].setIpAddress(QString("10.9.%1.2").arg(i));
+        b->interfaces()[1].setSubnetMask("255.255.255.252");
+        a->interfaces()[0].ospfCost = 10;
+        b->interfaces()[1].ospfCost = 10;
+        net->addLink({QString("ring-%1").arg(i), a->id(), "Gi0/0", b->id(), "Gi0/1"});
+    }
+    return net;
+}
+
+static void testWhatIfSweep()
+{
+    section("What-If Sweep");
+    QObject owner;
+    Network *net = buildOspfRing(&owner);
+    const DeviceStore snapshot = DeviceStore::fromNetwork(net);
+
+    // Reference: the full engine on a fresh copy of the network, per scenario
+    Network reference;
+    snapshot.toNetwork(&reference);
+    const SimulationResult baseline = RoutingEngine::run(&reference);
+    auto fullRun = [&](const std::function<void(Network *)> &change) {
+        Network copy;
+        snapshot.toNetwork(&copy);
+        change(&copy);
+        return RouteDiff::compute(baseline, RoutingEngine::run(&copy));
+    };
+    auto sameCounts = [](const RouteDiffResult &a, const RouteDiffResult &b) {
+        return a.added == b.added && a.removed == b.removed &&
+               a.nextHopChanged == b.nextHopChanged && a.metricChanged == b.metricChanged;
+    };
+
+    const QList<WhatIfScenario> failures = WhatIfSweep::linkFailures(net);
+    const WhatIfResult sweep = WhatIfSweep::run(net, failures);
+    check(failures.size() == 4 && sweep.outcomes.size() == 4 &&
+          RouteDiff::compute(baseline, sweep.baseline).isEmpty(),
+          "One outcome per link, against the engine's baseline");
+
+    bool matches = true, changed = true;
+    int spfRuns = 0;
+    for (int i = 0; i < failures.size(); ++i) {
+        const QString linkId = failures[i].changes.first().id;
+        const RouteDiffResult expected = fullRun([&](Network *n) { n->removeLink(linkId); });
+        matches = matches && sameCounts(sweep.outcomes[i].diff, expected);
+        changed = changed && !sweep.outcomes[i].diff.isEmpty();
+        spfRuns += sweep.outcomes[i].spfRuns;
+    }
+    check(matches && changed, "Each link failure diff matches a full re-run");
+    check(spfRuns < 4 * failures.size(), "Roots whose SPF tree avoids the link are not recomputed");
+
+    const QString r0 = net->routers().first()->id();
+    const WhatIfResult costs = WhatIfSweep::run(net, {
+        WhatIfSweep::scaledCosts(net, 2.0),
+        {"cheaper", {Perturbation::costChange(r0, "Gi0/0", 1)}},
+        {"router down", {Perturbation::routerDown(r0)}},
+        {"bad", {Perturbation::linkDown("no-such-link")}},
+    });
+    const RouteDiffResult &doubled = costs.outcomes[0].diff;
+    check(doubled.metricChanged > 0 && doubled.nextHopChanged == 0 && doubled.added == 0 &&
+          doubled.removed == 0, "Scaling every cost changes metrics, not paths");
+    const RouteDiffResult cheaper = fullRun([&](Network *n) {
+        n->device(r0)->getInterface("Gi0/0")->ospfCost = 1;
+    });
+    check(sameCounts(costs.outcomes[1].diff, cheaper) && costs.outcomes[1].spfRuns == 4,
+          "A cost decrease recomputes the whole domain");
+
+    int r0Rows = 0;
+    for (const RouterSimResult &rr : costs.baseline.routerResults)
+        if (rr.routerId == r0) r0Rows = rr.routingTable.size();
+    check(costs.outcomes[2].diff.removed >= r0Rows && costs.outcomes[2].diff.routersChanged == 4,
+          "A failed router loses its routes and everyone loses its LAN");
+    check(costs.outcomes[3].errors.size() == 1 && costs.outcomes[3].diff.isEmpty(),
+          "Unknown links are reported, not applied");
+
+    check(net->links().size() == 4 && net->routers().first()->interfaces()[0].ospfCost == 10,
+          "The swept network itself is left untouched");
+}
+
+// Uses Trace::Scope directly so it runs whether or not NETEMU_TRACING
+// compiled the library hooks in
+static void testTrace()
+{
+    section("Trace Export");
+
+    Trace::start();
+    {
+        Trace::Scope outer("outer");
+        QList<int> work = {0, 1, 2, 3, 4, 5, 6, 7};
+        QtConcurrent::blockingMap(work, [](int &v) {
+            Trace::Scope inner("inner");
+            for (int i = 0; i < 100000; ++i) v += i % 3;
+        });
+    }
+    Trace::stop();
+    { Trace::Scope ignored("after-stop"); }
+
+    QJsonParseError err;
+    const QJsonDocument doc = QJsonDocument::fromJson(Trace::chromeJson(), &err);
+    check(err.error == QJsonParseError::NoError && doc.isObject(), "Export is valid JSON");
+
+    int outer = 0, inner = 0, afterStop = 0, threadNames = 0;
+    bool wellFormed = true;
+    for (const QJsonValue &v : doc.object()["traceEvents"].toArray()) {
+        const QJsonObject e = v.toObject();
+        if (e["ph"].toString() == "M") { ++threadNames; continue; }
+        wellFormed = wellFormed && e["ph"].toString() == "X" && e.contains("tid") &&
+                     e["ts"].toDouble() >= 0 && e["dur"].toDouble() >= 0;
+        if (e["name"].toString() == "outer")      ++outer;
+        if (e["name"].toString() == "inner")      ++inner;
+        if (e["name"].toString() == "after-stop") ++afterStop;
+    }
+    check(outer == 1 && inner == 8, "Every scope is recorded once, across threads");
+    check(afterStop == 0, "Nothing is recorded after stop()");
+    check(threadNames >= 1 && wellFormed, "Complete events carry thread, timestamp and duration");
+
+    // A tiny ring keeps only the most recent events per thread
+    Trace::start(4);
+    for (int i = 0; i < 10; ++i) Trace::Scope s("ring");
+    Trace::stop();
+    int ring = 0;
+    for (const QJsonValue &v : QJsonDocument::fromJson(Trace::chromeJson()).object()["traceEvents"].toArray())
+        if (v.toObject()["name"].toString() == "ring") ++ring;
+    check(ring == 4, "Ring buffer overwrites the oldest events");
+}
+
 // ---------------------------------------------------------------------------
 // Entry point
 // ---------------------------------------------------------------------------
@@ -390,12 +1482,33 @@ int main(int argc, char *argv[])
     std::cout << "\nNetworkEmulator — Simulation & Validation Tests\n";
     std::cout << "================================================\n";
 
+    testIpUtils();
+    testInterfaceAddress();
+    testIpv6();
     testRipv2();
     testOspf();
     testStatic();
+    testPimBatch();
+    testPimRpf();
+    testPimUpstreamReceiver();
     testValidationClean();
     testValidationErrors();
+    testDataPlane();
+    testReachabilityMatrix();
     testSaveLoad();
+    testDeviceStore();
+    testChangeSignals();
+    testDeviceLists();
+    testAddressIndex();
+    testStringPool();
+    testScratchArena();
+    testForceLayout();
+    testRoutingTableModel();
+    testRouteDiff();
+    testSimulationStats();
+    testResultReuse();
+    testWhatIfSweep();
+    testTrace();
 
     std::cout << "\n------------------------------------------------\n";
     std::cout << "Results: " << g_passed << " passed, " << g_failed << " failed.\n";
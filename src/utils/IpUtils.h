@@ -1,28 +1,169 @@
 #pragma once
 #include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QList>
+#include <QHashFunctions>
+#include <array>
 #include <climits>
 
 namespace IpUtils {
 
-inline quint32 parse(const QString &ip)
+// ---------------------------------------------------------------------------
+// Dotted-quad parsing
+//
+// A single pass over the characters with no allocation.  Each octet is one to
+// three decimal digits (leading zeros are accepted, as before) in 0..255.
+// The IPv6 parser further down reports through the same codes, with "octet"
+// standing for a 16-bit group.
+// ---------------------------------------------------------------------------
+enum class ParseError {
+    None,
+    Empty,             // no characters at all
+    InvalidCharacter,  // anything other than digits and '.' (hex digits and ':' for IPv6)
+    EmptyOctet,        // "1..2.3", ".1.2.3", "1.2.3."
+    OctetOutOfRange,   // above 255, or more than three digits (four hex digits)
+    TooFewOctets,
+    TooManyOctets,
+    InvalidCompression, // IPv6: more than one "::", or "::" with all eight groups
+    InvalidPrefix,      // "/len" missing or out of range
+};
+
+inline const char *errorString(ParseError error)
+{
+    switch (error) {
+        case ParseError::None:             return "no error";
+        case ParseError::Empty:            return "address is empty";
+        case ParseError::InvalidCharacter: return "invalid character";
+        case ParseError::EmptyOctet:       return "empty octet";
+        case ParseError::OctetOutOfRange:  return "octet out of range";
+        case ParseError::TooFewOctets:     return "too few octets";
+        case ParseError::TooManyOctets:    return "too many octets";
+        case ParseError::InvalidCompression: return "misplaced '::'";
+        case ParseError::InvalidPrefix:    return "invalid prefix length";
+    }
+    return "unknown error";
+}
+
+// Returns 0 on failure; 'error' tells failures apart from 0.0.0.0
+inline quint32 parse(QStringView ip, ParseError *error = nullptr)
 {
-    const QStringList parts = ip.split('.');
-    if (parts.size() != 4) return 0;
+    auto fail = [error](ParseError e) {
+        if (error) *error = e;
+        return quint32(0);
+    };
+    if (ip.isEmpty()) return fail(ParseError::Empty);
+
     quint32 result = 0;
-    for (int i = 0; i < 4; ++i)
-        result = (result << 8) | (parts[i].toUInt() & 0xFF);
-    return result;
+    uint    octet  = 0;
+    int     digits = 0;
+    int     dots   = 0;
+    for (const QChar qc : ip) {
+        const uint d = uint(qc.unicode()) - '0';
+        if (d < 10) {
+            octet = octet * 10 + d;
+            if (++digits > 3) return fail(ParseError::OctetOutOfRange);
+        } else if (qc == u'.') {
+            if (digits == 0)  return fail(ParseError::EmptyOctet);
+            if (octet > 255)  return fail(ParseError::OctetOutOfRange);
+            if (++dots > 3)   return fail(ParseError::TooManyOctets);
+            result = (result << 8) | octet;
+            octet  = 0;
+            digits = 0;
+        } else {
+            return fail(ParseError::InvalidCharacter);
+        }
+    }
+    if (digits == 0) return fail(ParseError::EmptyOctet);
+    if (octet > 255) return fail(ParseError::OctetOutOfRange);
+    if (dots < 3)    return fail(ParseError::TooFewOctets);
+
+    if (error) *error = ParseError::None;
+    return (result << 8) | octet;
+}
+
+// Column variant for bulk imports: parses texts[0..count) into out[], leaving
+// 0 (and the error, when 'errors' is given) for malformed entries.  Returns
+// the number of failures.
+inline qsizetype parseBatch(const QStringView *texts, qsizetype count, quint32 *out,
+                            ParseError *errors = nullptr)
+{
+    qsizetype failures = 0;
+    for (qsizetype i = 0; i < count; ++i) {
+        ParseError e;
+        out[i] = parse(texts[i], &e);
+        if (errors) errors[i] = e;
+        failures += (e != ParseError::None);
+    }
+    return failures;
+}
+
+inline QList<quint32> parseAll(const QStringList &texts, qsizetype *failures = nullptr)
+{
+    QList<quint32> out(texts.size());
+    qsizetype failed = 0;
+    for (qsizetype i = 0; i < texts.size(); ++i) {
+        ParseError e;
+        out[i] = parse(texts[i], &e);
+        failed += (e != ParseError::None);
+    }
+    if (failures) *failures = failed;
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Dotted-quad formatting
+// ---------------------------------------------------------------------------
+constexpr int MAX_TEXT_LENGTH    = 15;                  // "255.255.255.255"
+constexpr int FORMAT_BUFFER_SIZE = MAX_TEXT_LENGTH + 1; // formatTo() writes one scratch byte
+
+namespace detail {
+struct OctetText {
+    char length;
+    char digits[3];
+};
+
+// "0".."255" precomputed, so formatting is four table copies
+inline constexpr std::array<OctetText, 256> OCTET_TEXT = [] {
+    std::array<OctetText, 256> table{};
+    for (int v = 0; v < 256; ++v) {
+        OctetText &t = table[v];
+        if (v >= 100)     { t.length = 3; t.digits[0] = char('0' + v / 100);
+                            t.digits[1] = char('0' + v / 10 % 10); t.digits[2] = char('0' + v % 10); }
+        else if (v >= 10) { t.length = 2; t.digits[0] = char('0' + v / 10); t.digits[1] = char('0' + v % 10); }
+        else              { t.length = 1; t.digits[0] = char('0' + v); }
+    }
+    return table;
+}();
+} // namespace detail
+
+// Writes the address into 'buffer' (FORMAT_BUFFER_SIZE chars; the result is
+// not NUL-terminated) and returns its length.  Every octet copies three digit
+// bytes and a dot unconditionally; only the advance depends on the value.
+inline int formatTo(quint32 ip, char *buffer)
+{
+    char *p = buffer;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        const detail::OctetText &t = detail::OCTET_TEXT[(ip >> shift) & 0xFF];
+        p[0] = t.digits[0];
+        p[1] = t.digits[1];
+        p[2] = t.digits[2];
+        p += t.length;
+        *p = '.';
+        p += (shift != 0);
+    }
+    return int(p - buffer);
 }
 
 inline QString format(quint32 ip)
 {
-    return QString("%1.%2.%3.%4")
-        .arg((ip >> 24) & 0xFF)
-        .arg((ip >> 16) & 0xFF)
-        .arg((ip >> 8)  & 0xFF)
-        .arg(ip         & 0xFF);
+    char buffer[FORMAT_BUFFER_SIZE];
+    return QString::fromLatin1(buffer, formatTo(ip, buffer));
 }
 
+// ---------------------------------------------------------------------------
+// Masks and subnets
+// ---------------------------------------------------------------------------
 inline quint32 networkAddress(quint32 ip, quint32 mask)
 {
     return ip & mask;
@@ -41,31 +182,227 @@ inline quint32 prefixToMask(int prefix)
     return ~((1u << (32 - prefix)) - 1);
 }
 
-inline bool isValidIp(const QString &ip)
+inline bool isValidIp(QStringView ip)
 {
-    const QStringList parts = ip.split('.');
-    if (parts.size() != 4) return false;
-    for (const auto &p : parts) {
-        bool ok;
-        int v = p.toInt(&ok);
-        if (!ok || v < 0 || v > 255) return false;
-    }
-    return true;
+    ParseError error;
+    parse(ip, &error);
+    return error == ParseError::None;
 }
 
-inline bool isValidMask(const QString &mask)
+inline bool isValidMask(QStringView mask)
 {
-    if (!isValidIp(mask)) return false;
-    quint32 m = parse(mask);
+    ParseError error;
+    const quint32 m = parse(mask, &error);
+    if (error != ParseError::None) return false;
     // Valid masks have contiguous leading 1s
     quint32 inv = ~m;
     return ((inv + 1) & inv) == 0;
 }
 
-inline bool sameSubnet(const QString &ip1, const QString &ip2, const QString &mask)
+inline bool sameSubnet(QStringView ip1, QStringView ip2, QStringView mask)
 {
     quint32 m = parse(mask);
     return networkAddress(parse(ip1), m) == networkAddress(parse(ip2), m);
 }
 
+// ---------------------------------------------------------------------------
+// IPv6
+//
+// Ip6Address holds the 128 bits as two host-order words, so masking and
+// comparing are two integer operations each.  Text follows RFC 5952 on
+// output (lower-case, longest zero run compressed) and accepts RFC 4291
+// forms on input, including a trailing dotted quad.
+// ---------------------------------------------------------------------------
+struct Ip6Address {
+    quint64 hi = 0;
+    quint64 lo = 0;
+
+    static Ip6Address prefixMask(int length)
+    {
+        length = qBound(0, length, 128);
+        Ip6Address m;
+        m.hi = length >= 64 ? ~quint64(0) : length == 0 ? 0 : ~quint64(0) << (64 - length);
+        m.lo = length <= 64 ? 0 : length == 128 ? ~quint64(0) : ~quint64(0) << (128 - length);
+        return m;
+    }
+
+    // IPv4 bits left-aligned, for structures keyed on bit strings
+    static Ip6Address fromIpv4Bits(quint32 ip) { return {quint64(ip) << 32, 0}; }
+
+    Ip6Address masked(int length) const { return *this & prefixMask(length); }
+    bool isZero() const { return (hi | lo) == 0; }
+
+    // Byte 'i' (0 = most significant) and 16-bit group 'i'
+    int byte(int i)  const { return int(((i < 8 ? hi : lo) >> (56 - 8 * (i & 7))) & 0xFF); }
+    int group(int i) const { return int(((i < 4 ? hi : lo) >> (48 - 16 * (i & 3))) & 0xFFFF); }
+
+    friend Ip6Address operator&(const Ip6Address &a, const Ip6Address &b) { return {a.hi & b.hi, a.lo & b.lo}; }
+    friend bool operator==(const Ip6Address &a, const Ip6Address &b) { return a.hi == b.hi && a.lo == b.lo; }
+    friend bool operator!=(const Ip6Address &a, const Ip6Address &b) { return !(a == b); }
+    friend bool operator<(const Ip6Address &a, const Ip6Address &b)
+    {
+        return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+    }
+};
+
+inline size_t qHash(const Ip6Address &a, size_t seed = 0)
+{
+    return qHashMulti(seed, a.hi, a.lo);
+}
+
+inline bool isIpv6Text(QStringView text)
+{
+    return text.contains(u':');
+}
+
+inline Ip6Address parse6(QStringView ip, ParseError *error = nullptr)
+{
+    auto fail = [error](ParseError e) {
+        if (error) *error = e;
+        return Ip6Address{};
+    };
+    if (ip.isEmpty()) return fail(ParseError::Empty);
+
+    quint16 groups[8] = {};
+    int count    = 0;
+    int compress = -1; // group index where "::" stands
+    qsizetype i  = 0;
+    const qsizetype n = ip.size();
+
+    if (ip.startsWith(u"::")) {
+        compress = 0;
+        i = 2;
+    } else if (ip.front() == u':') {
+        return fail(ParseError::EmptyOctet);
+    }
+
+    while (i < n) {
+        const qsizetype start = i;
+        uint value  = 0;
+        int  digits = 0;
+        for (; i < n; ++i) {
+            const char16_t c = ip[i].unicode();
+            uint d;
+            if      (c >= u'0' && c <= u'9') d = c - u'0';
+            else if (c >= u'a' && c <= u'f') d = c - u'a' + 10;
+            else if (c >= u'A' && c <= u'F') d = c - u'A' + 10;
+            else break;
+            value = (value << 4) | d;
+            ++digits;
+        }
+        if (i < n && ip[i] == u'.') { // trailing dotted quad fills two groups
+            ParseError e;
+            const quint32 v4 = parse(ip.mid(start), &e);
+            if (e != ParseError::None) return fail(e);
+            if (count > 6) return fail(ParseError::TooManyOctets);
+            groups[count++] = quint16(v4 >> 16);
+            groups[count++] = quint16(v4);
+            i = n;
+            break;
+        }
+        if (digits == 0)  return fail(i < n && ip[i] != u':' ? ParseError::InvalidCharacter
+                                                             : ParseError::EmptyOctet);
+        if (digits > 4)   return fail(ParseError::OctetOutOfRange);
+        if (count == 8)   return fail(ParseError::TooManyOctets);
+        groups[count++] = quint16(value);
+
+        if (i == n) break;
+        if (ip[i] != u':') return fail(ParseError::InvalidCharacter);
+        if (++i == n)      return fail(ParseError::EmptyOctet); // trailing single ':'
+        if (ip[i] == u':') {
+            if (compress >= 0) return fail(ParseError::InvalidCompression);
+            compress = count;
+            ++i;
+        }
+    }
+
+    if (compress < 0 && count < 8)  return fail(ParseError::TooFewOctets);
+    if (compress >= 0 && count == 8) return fail(ParseError::InvalidCompression);
+
+    quint16 full[8] = {};
+    const int tail = compress < 0 ? 0 : count - compress;
+    for (int g = 0; g < count - tail; ++g) full[g] = groups[g];
+    for (int g = 0; g < tail; ++g)         full[8 - tail + g] = groups[count - tail + g];
+
+    Ip6Address a;
+    for (int g = 0; g < 4; ++g) a.hi = (a.hi << 16) | full[g];
+    for (int g = 4; g < 8; ++g) a.lo = (a.lo << 16) | full[g];
+    if (error) *error = ParseError::None;
+    return a;
+}
+
+// "addr/len"; the address is returned as written (not masked)
+inline bool parseCidr6(QStringView text, Ip6Address *address, int *length,
+                       ParseError *error = nullptr)
+{
+    const qsizetype slash = text.indexOf(u'/');
+    ParseError e = ParseError::None;
+    Ip6Address a;
+    int len = -1;
+    if (slash < 0) {
+        e = text.isEmpty() ? ParseError::Empty : ParseError::InvalidPrefix;
+    } else {
+        a = parse6(text.left(slash), &e);
+        bool ok = false;
+        len = text.mid(slash + 1).toInt(&ok);
+        if (e == ParseError::None && (!ok || len < 0 || len > 128)) e = ParseError::InvalidPrefix;
+    }
+    if (error) *error = e;
+    if (e != ParseError::None) return false;
+    if (address) *address = a;
+    if (length)  *length  = len;
+    return true;
+}
+
+inline bool isValidIp6(QStringView ip)
+{
+    ParseError error;
+    parse6(ip, &error);
+    return error == ParseError::None;
+}
+
+constexpr int MAX_TEXT6_LENGTH    = 39; // "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"
+constexpr int FORMAT6_BUFFER_SIZE = MAX_TEXT6_LENGTH + 1;
+
+// RFC 5952 text into 'buffer' (FORMAT6_BUFFER_SIZE chars, not NUL-terminated)
+inline int formatTo6(const Ip6Address &ip, char *buffer)
+{
+    // Longest run of two or more zero groups; the first one wins a tie
+    int bestStart = -1, bestLength = 1;
+    for (int g = 0; g < 8; ) {
+        if (ip.group(g) != 0) { ++g; continue; }
+        int end = g;
+        while (end < 8 && ip.group(end) == 0) ++end;
+        if (end - g > bestLength) { bestStart = g; bestLength = end - g; }
+        g = end;
+    }
+
+    static constexpr char HEX[] = "0123456789abcdef";
+    char *p = buffer;
+    for (int g = 0; g < 8; ++g) {
+        if (g == bestStart) {
+            *p++ = ':';
+            if (g == 0) *p++ = ':';
+            g += bestLength - 1;
+            continue;
+        }
+        const int v = ip.group(g);
+        bool leading = true;
+        for (int shift = 12; shift >= 0; shift -= 4) {
+            const int d = (v >> shift) & 0xF;
+            if (leading && d == 0 && shift > 0) continue;
+            leading = false;
+            *p++ = HEX[d];
+        }
+        if (g < 7) *p++ = ':';
+    }
+    return int(p - buffer);
+}
+
+inline QString format6(const Ip6Address &ip)
+{
+    char buffer[FORMAT6_BUFFER_SIZE];
+    return QString::fromLatin1(buffer, formatTo6(ip, buffer));
+}
+
 } // namespace IpUtils
@@ -0,0 +1,97 @@
+#pragma once
+#include <QList>
+#include <array>
+#include "utils/IpUtils.h"
+
+// ---------------------------------------------------------------------------
+// PrefixTrie
+//
+// Longest-prefix match over up to 128-bit keys, as a multibit trie with an
+// 8-bit stride: a lookup reads at most one node per key byte (4 for IPv4,
+// 16 for IPv6) instead of testing every prefix.  Prefixes are expanded into
+// the slots of the node at their last byte (controlled prefix expansion), and
+// a slot keeps the longest prefix covering it; between equal lengths the
+// first one inserted wins, like a stable longest-first scan.
+//
+// Keys are left-aligned bit strings: IPv6 addresses as they are, IPv4
+// addresses through Ip6Address::fromIpv4Bits() (or insert4/lookup4).
+// ---------------------------------------------------------------------------
+class PrefixTrie
+{
+public:
+    PrefixTrie() { m_nodes.resize(1); }
+
+    void insert(const IpUtils::Ip6Address &prefix, int length, int value)
+    {
+        length = qBound(0, length, 128);
+        if (length == 0) {
+            if (m_defaultLength < 0) { m_default = value; m_defaultLength = 0; }
+            ++m_size;
+            return;
+        }
+        const IpUtils::Ip6Address key = prefix.masked(length);
+        const int last = (length - 1) / STRIDE; // byte holding the prefix's last bit
+
+        int node = 0;
+        for (int depth = 0; depth < last; ++depth) {
+            int child = m_nodes[node].slots[key.byte(depth)].child;
+            if (child < 0) {
+                child = static_cast<int>(m_nodes.size());
+                m_nodes[node].slots[key.byte(depth)].child = child; // before resize invalidates
+                m_nodes.resize(child + 1);
+            }
+            node = child;
+        }
+
+        const int free  = (last + 1) * STRIDE - length; // unconstrained low bits in the byte
+        const int first = key.byte(last);
+        for (int b = first; b < first + (1 << free); ++b) {
+            Slot &slot = m_nodes[node].slots[b];
+            if (length > slot.length) {
+                slot.length = static_cast<qint16>(length);
+                slot.value  = value;
+            }
+        }
+        ++m_size;
+    }
+
+    // Value of the longest prefix covering 'address', or -1
+    int lookup(const IpUtils::Ip6Address &address) const
+    {
+        int best = m_default;
+        int node = 0;
+        for (int depth = 0; depth < 128 / STRIDE; ++depth) {
+            const Slot &slot = m_nodes[node].slots[address.byte(depth)];
+            if (slot.length >= 0) best = slot.value;
+            if (slot.child < 0) break;
+            node = slot.child;
+        }
+        return best;
+    }
+
+    void insert4(quint32 network, int length, int value)
+    {
+        insert(IpUtils::Ip6Address::fromIpv4Bits(network), qBound(0, length, 32), value);
+    }
+    int lookup4(quint32 address) const { return lookup(IpUtils::Ip6Address::fromIpv4Bits(address)); }
+
+    int  size() const    { return m_size; } // prefixes inserted
+    bool isEmpty() const { return m_size == 0; }
+
+private:
+    static constexpr int STRIDE = 8;
+
+    struct Slot {
+        int    value  = -1;
+        qint16 length = -1; // of the prefix stored here; -1 when none
+        int    child  = -1; // next-level node index
+    };
+    struct Node {
+        std::array<Slot, 1 << STRIDE> slots;
+    };
+
+    QList<Node> m_nodes;
+    int         m_default       = -1;
+    int         m_defaultLength = -1;
+    int         m_size          = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// ScratchArena
+//
+// Memory for the short-lived containers of one protocol run (distances,
+// visited sets, BFS queues, ...).  Blocks are carved from a monotonic buffer
+// and recycled through an unsynchronized pool, so containers that grow, shrink
+// or are rebuilt per root reuse freed blocks, and nothing goes back to the
+// system allocator until the arena is destroyed at the end of the run.
+//
+// Not thread-safe: give each worker thread its own arena.  Containers drawing
+// from it must not outlive it, and nested pmr containers inherit its resource.
+// ---------------------------------------------------------------------------
+class ScratchArena
+{
+public:
+    template <typename T>
+    using Vector = std::pmr::vector<T>;
+    template <typename K, typename V, typename H = std::hash<K>>
+    using Hash = std::pmr::unordered_map<K, V, H>;
+    template <typename T, typename H = std::hash<T>>
+    using Set = std::pmr::unordered_set<T, H>;
+
+    ScratchArena() = default;
+    ScratchArena(const ScratchArena &) = delete;
+    ScratchArena &operator=(const ScratchArena &) = delete;
+
+    std::pmr::memory_resource *resource() { return &m_pool; }
+
+private:
+    static constexpr std::size_t INLINE_BYTES = 4096; // small runs never touch the heap
+
+    alignas(std::max_align_t) std::byte   m_inline[INLINE_BYTES];
+    std::pmr::monotonic_buffer_resource   m_buffer{m_inline, INLINE_BYTES};
+    std::pmr::unsynchronized_pool_resource m_pool{&m_buffer};
+};
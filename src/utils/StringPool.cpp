@@ -0,0 +1,29 @@
+#include "utils/StringPool.h"
+
+Symbol StringPool::intern(const QString &text)
+{
+    auto it = m_symbols.constFind(text);
+    if (it != m_symbols.constEnd()) return {it.value()};
+
+    const quint32 id = quint32(m_strings.size());
+    m_strings.append(text);
+    m_symbols.insert(text, id);
+    return {id};
+}
+
+Symbol StringPool::find(const QString &text) const
+{
+    auto it = m_symbols.constFind(text);
+    return it != m_symbols.constEnd() ? Symbol{it.value()} : Symbol{};
+}
+
+QString StringPool::text(Symbol symbol) const
+{
+    return symbol.id < quint32(m_strings.size()) ? m_strings[symbol.id] : QString();
+}
+
+void StringPool::clear()
+{
+    m_symbols.clear();
+    m_strings.clear();
+}
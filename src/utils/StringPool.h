@@ -0,0 +1,53 @@
+#pragma once
+#include <QString>
+#include <QHash>
+#include <QList>
+
+// ---------------------------------------------------------------------------
+// Symbol
+//
+// 32-bit name of an interned string: equal symbols mean equal text, so
+// comparing two symbols is one integer compare.  Only meaningful within the
+// pool that produced it.
+// ---------------------------------------------------------------------------
+struct Symbol {
+    static constexpr quint32 NONE = 0xFFFFFFFFu;
+
+    quint32 id = NONE;
+
+    bool isValid() const { return id != NONE; }
+
+    friend bool operator==(Symbol a, Symbol b) { return a.id == b.id; }
+    friend bool operator!=(Symbol a, Symbol b) { return a.id != b.id; }
+};
+
+inline size_t qHash(Symbol s, size_t seed = 0) { return qHash(s.id, seed); }
+
+// ---------------------------------------------------------------------------
+// StringPool
+//
+// String table for the text that repeats across a model.  Each Network owns
+// one for its device ids (shared by every link that names them) and
+// interface names ("Gi0/0" on every router), and empties it with its
+// contents, so text lives as long as the network rather than the process.
+// pooled() returns the pool's copy, so equal strings share one buffer
+// through QString's implicit sharing.
+// Like the Network that owns it, only const lookups may run concurrently.
+// ---------------------------------------------------------------------------
+class StringPool
+{
+public:
+    Symbol  intern(const QString &text);
+    Symbol  find(const QString &text) const; // invalid if never interned
+    QString text(Symbol symbol) const;       // shares the pooled buffer
+
+    // The pooled copy of 'text' (interning it if needed)
+    QString pooled(const QString &text) { return m_strings[intern(text).id]; }
+
+    int  size() const { return int(m_strings.size()); }
+    void clear();
+
+private:
+    QHash<QString, quint32> m_symbols;
+    QList<QString>          m_strings; // indexed by Symbol::id
+};
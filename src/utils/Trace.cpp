@@ -0,0 +1,161 @@
+#include "utils/Trace.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+std::atomic<bool> Trace::detail::active{false};
+
+// ---------------------------------------------------------------------------
+// Per-thread ring buffers
+// ---------------------------------------------------------------------------
+namespace {
+
+struct Event {
+    const char *name;
+    qint64      beginNs;
+    qint64      endNs;
+};
+
+struct ThreadBuffer {
+    int                tid = 0;
+    QString            name;
+    std::vector<Event> ring;
+    quint64            written = 0; // total since start(); ring holds the last ring.size()
+};
+
+struct Registry {
+    QMutex                                     mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers; // outlive their threads
+    int                                        capacity = 1 << 16;
+    qint64                                     startNs  = 0;
+};
+
+Registry &registry()
+{
+    static Registry r;
+    return r;
+}
+
+thread_local ThreadBuffer *t_buffer = nullptr;
+
+ThreadBuffer *threadBuffer()
+{
+    if (t_buffer) return t_buffer;
+
+    Registry &reg = registry();
+    QMutexLocker lock(&reg.mutex);
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->tid = static_cast<int>(reg.buffers.size()) + 1;
+
+    QThread *thread = QThread::currentThread();
+    const auto *app = QCoreApplication::instance();
+    if (app && thread == app->thread())        buffer->name = "main";
+    else if (!thread->objectName().isEmpty())  buffer->name = thread->objectName();
+    else                                       buffer->name = QString("worker %1").arg(buffer->tid);
+
+    buffer->ring.resize(reg.capacity);
+    t_buffer = buffer.get();
+    reg.buffers.push_back(std::move(buffer));
+    return t_buffer;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+qint64 Trace::nowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::start(int eventsPerThread)
+{
+    Registry &reg = registry();
+    QMutexLocker lock(&reg.mutex);
+    reg.capacity = std::max(1, eventsPerThread);
+    reg.startNs  = nowNs();
+    for (auto &buffer : reg.buffers) {
+        buffer->ring.assign(reg.capacity, Event{});
+        buffer->written = 0;
+    }
+    detail::active.store(true, std::memory_order_release);
+}
+
+void Trace::stop()
+{
+    detail::active.store(false, std::memory_order_release);
+}
+
+void Trace::record(const char *name, qint64 beginNs, qint64 endNs)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    buffer->ring[buffer->written % buffer->ring.size()] = {name, beginNs, endNs};
+    ++buffer->written;
+}
+
+// ---------------------------------------------------------------------------
+// Export
+// ---------------------------------------------------------------------------
+static void appendJsonString(QByteArray &out, const QByteArray &s)
+{
+    out += '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) { out += ' '; continue; }
+        out += c;
+    }
+    out += '"';
+}
+
+QByteArray Trace::chromeJson()
+{
+    Registry &reg = registry();
+    QMutexLocker lock(&reg.mutex);
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&] { if (!first) out += ",\n"; first = false; };
+
+    for (const auto &buffer : reg.buffers) {
+        if (buffer->written == 0) continue;
+        const QByteArray tid = QByteArray::number(buffer->tid);
+
+        separator();
+        out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid + ",\"tid\":" + tid +
+               ",\"args\":{\"name\":";
+        appendJsonString(out, buffer->name.toUtf8());
+        out += "}}";
+
+        const quint64 size  = buffer->ring.size();
+        const quint64 begin = buffer->written > size ? buffer->written - size : 0;
+        for (quint64 i = begin; i < buffer->written; ++i) {
+            const Event &e = buffer->ring[i % size];
+            if (e.beginNs < reg.startNs) continue; // from before the last start()
+            separator();
+            out += "{\"ph\":\"X\",\"name\":";
+            appendJsonString(out, e.name);
+            out += ",\"pid\":" + pid + ",\"tid\":" + tid +
+                   ",\"ts\":"  + QByteArray::number((e.beginNs - reg.startNs) / 1e3, 'f', 3) +
+                   ",\"dur\":" + QByteArray::number((e.endNs - e.beginNs) / 1e3, 'f', 3) + "}";
+        }
+    }
+    out += "]}\n";
+    return out;
+}
+
+bool Trace::writeChromeJson(const QString &filePath, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    file.write(chromeJson());
+    return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+
+// ---------------------------------------------------------------------------
+// Trace
+//
+// Scoped wall-clock tracing for finding where a run spends its time, and on
+// which threads.  TRACE_SCOPE("name") records one complete event from the
+// point of declaration to the end of the enclosing block.  Events go into a
+// fixed-size ring buffer owned by the recording thread (no locking on the hot
+// path; the oldest events are overwritten when it fills) and are exported as
+// Chrome trace-event JSON, which ui.perfetto.dev and chrome://tracing open.
+//
+// The hooks compile to nothing unless the build defines NETEMU_TRACING (the
+// CMake option of the same name); when compiled in they cost one relaxed
+// atomic load while no trace is active.  Names must be string literals.
+//
+// start(), stop() and the export functions are not safe to call while traced
+// work is running on other threads; call them between runs.
+// ---------------------------------------------------------------------------
+namespace Trace {
+
+namespace detail {
+extern std::atomic<bool> active;
+}
+
+// Clears every thread's buffer and starts recording
+void start(int eventsPerThread = 1 << 16);
+void stop();
+inline bool isActive() { return detail::active.load(std::memory_order_relaxed); }
+
+// Events recorded since start(), with one thread_name record per thread
+QByteArray chromeJson();
+bool writeChromeJson(const QString &filePath, QString *error = nullptr);
+
+qint64 nowNs();
+void record(const char *name, qint64 beginNs, qint64 endNs);
+
+class Scope
+{
+public:
+    explicit Scope(const char *name) : m_name(name), m_beginNs(isActive() ? nowNs() : -1) {}
+    ~Scope() { if (m_beginNs >= 0) record(m_name, m_beginNs, nowNs()); }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *m_name;
+    qint64      m_beginNs;
+};
+
+} // namespace Trace
+
+#ifdef NETEMU_TRACING
+#  define NETEMU_TRACE_CONCAT_(a, b) a##b
+#  define NETEMU_TRACE_CONCAT(a, b)  NETEMU_TRACE_CONCAT_(a, b)
+#  define TRACE_SCOPE(name) const Trace::Scope NETEMU_TRACE_CONCAT(traceScope_, __LINE__)(name)
+#else
+#  define TRACE_SCOPE(name) do {} while (false)
+#endif
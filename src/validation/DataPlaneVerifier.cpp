@@ -0,0 +1,76 @@
+#include "validation/DataPlaneVerifier.h"
+#include "validation/ForwardingModel.h"
+#include "models/Network.h"
+#include <QHash>
+
+static QStringList routerNames(const ForwardingModel &model, const QList<int> &path)
+{
+    QStringList names;
+    for (int r : path) names.append(model.router(r)->name());
+    return names;
+}
+
+// ---------------------------------------------------------------------------
+DataPlaneReport DataPlaneVerifier::verify(Network *network)
+{
+    const ForwardingModel model(network);
+
+    DataPlaneReport report;
+    report.equivalenceClasses = static_cast<int>(model.classes().size());
+
+    for (int ec = 0; ec < model.classes().size(); ++ec) {
+        const QList<ForwardingModel::Resolution> res = model.resolveClass(ec);
+
+        // One issue per fault site; further routers feeding into it only bump the count
+        QHash<qint64, int> reported; // (outcome, terminal) -> index into report.issues
+
+        for (int r = 0; r < model.routerCount(); ++r) {
+            if (model.fibEntry(r, ec) < 0) continue;
+            ++report.pairsChecked;
+
+            const ForwardingModel::Resolution &rs = res[r];
+            if (rs.outcome == ForwardingModel::Outcome::Delivered) continue;
+
+            const qint64 key = (qint64(rs.outcome) << 32) | quint32(rs.terminal);
+            auto seen = reported.constFind(key);
+            if (seen != reported.constEnd()) {
+                ++report.issues[seen.value()].affectedRouters;
+                continue;
+            }
+
+            const Router *at = model.router(rs.terminal);
+            ForwardingIssue issue;
+            issue.destination = model.describeClass(ec);
+            issue.routerId    = at->id();
+            issue.path        = routerNames(model, model.path(r, ec));
+
+            switch (rs.outcome) {
+                case ForwardingModel::Outcome::Loop:
+                    issue.kind    = ForwardingIssue::Kind::Loop;
+                    issue.message = QString("Forwarding loop for %1: %2")
+                                        .arg(issue.destination, issue.path.join(" -> "));
+                    break;
+                case ForwardingModel::Outcome::BlackHole:
+                    issue.kind    = ForwardingIssue::Kind::BlackHole;
+                    issue.message = QString("Black hole for %1: '%2' has no matching route (%3)")
+                                        .arg(issue.destination, at->name(), issue.path.join(" -> "));
+                    break;
+                default: {
+                    const RoutingEntry &e = at->computedRoutingTable()[model.fibEntry(rs.terminal, ec)];
+                    issue.kind    = ForwardingIssue::Kind::DeadNextHop;
+                    issue.message = QString("Dead next hop for %1: '%2' forwards to %3 via %4, "
+                                            "which no neighboring router owns (%5)")
+                                        .arg(issue.destination, at->name(), e.nextHop,
+                                             e.exitInterface.isEmpty() ? QString("no interface")
+                                                                       : e.exitInterface,
+                                             issue.path.join(" -> "));
+                    break;
+                }
+            }
+
+            reported.insert(key, static_cast<int>(report.issues.size()));
+            report.issues.append(issue);
+        }
+    }
+    return report;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+class Network;
+
+struct ForwardingIssue {
+    enum class Kind { Loop, BlackHole, DeadNextHop };
+
+    Kind        kind;
+    QString     destination;         // equivalence class, as a prefix or address range
+    QString     routerId;            // router at which forwarding fails
+    QStringList path;                // witness: router names from the first affected router
+    int         affectedRouters = 1; // routers whose packets for 'destination' hit this fault
+    QString     message;
+
+    QString kindString() const {
+        switch (kind) {
+            case Kind::Loop:        return "LOOP";
+            case Kind::BlackHole:   return "BLACK HOLE";
+            case Kind::DeadNextHop: return "DEAD NEXT HOP";
+        }
+        return {};
+    }
+};
+
+struct DataPlaneReport {
+    QList<ForwardingIssue> issues;
+    int equivalenceClasses = 0;
+    int pairsChecked       = 0; // (router, equivalence class) pairs with a route
+};
+
+class DataPlaneVerifier
+{
+public:
+    // Follows the computed routing tables (RoutingEngine::run must have been
+    // called) for every router and every destination it has a route for, and
+    // reports forwarding loops, black holes and next hops that no neighbor owns.
+    static DataPlaneReport verify(Network *network);
+};
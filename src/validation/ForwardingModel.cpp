@@ -0,0 +1,302 @@
+#include "validation/ForwardingModel.h"
+#include "models/Network.h"
+#include "utils/IpUtils.h"
+#include <QSet>
+#include <QQueue>
+#include <algorithm>
+#include <iterator>
+
+// ---------------------------------------------------------------------------
+// A routing-table row reduced to the address range it covers
+// ---------------------------------------------------------------------------
+struct PrefixRange {
+    quint32 first;
+    quint32 last;
+    int     length;
+    int     entry; // index into the router's computed routing table
+};
+
+static PrefixRange rangeOf(const RoutingEntry &e, int index)
+{
+    const int     len  = IpUtils::maskToPrefix(IpUtils::parse(e.mask));
+    const quint32 mask = IpUtils::prefixToMask(len);
+    const quint32 net  = IpUtils::parse(e.destination) & mask;
+    return {net, net | ~mask, len, index};
+}
+
+ForwardingModel::ForwardingModel(Network *network)
+    : m_network(network)
+{
+    m_routers = network->routers();
+    for (int i = 0; i < m_routers.size(); ++i)
+        m_routerIndex.insert(m_routers[i]->id(), i);
+
+    buildClasses();
+    buildFibs();
+}
+
+// ---------------------------------------------------------------------------
+// Equivalence classes: split the address space at every prefix boundary and
+// keep the atomic ranges that at least one prefix covers.
+// ---------------------------------------------------------------------------
+void ForwardingModel::buildClasses()
+{
+    QList<QPair<quint64, int>> events; // boundary -> coverage delta
+    for (auto *r : m_routers) {
+        const auto &table = r->computedRoutingTable();
+        for (int i = 0; i < table.size(); ++i) {
+            if (table[i].isIpv6()) continue; // the classes cover IPv4 only
+            const PrefixRange p = rangeOf(table[i], i);
+            events.append({p.first, +1});
+            events.append({quint64(p.last) + 1, -1});
+        }
+    }
+    std::sort(events.begin(), events.end());
+
+    int coverage = 0;
+    for (int i = 0; i < events.size(); ) {
+        const quint64 at = events[i].first;
+        while (i < events.size() && events[i].first == at)
+            coverage += events[i++].second;
+        if (coverage > 0 && i < events.size())
+            m_classes.append({quint32(at), quint32(events[i].first - 1)});
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Per-router longest-prefix match, stored as runs of classes sharing an entry.
+// A router's match can only change at its own prefix boundaries, so only the
+// classes starting there are visited: O(P log C) per router rather than one
+// slot per class.  CIDR prefixes either nest or are disjoint, so a stack of
+// open prefixes swept by start address always has the most specific match on
+// top.
+// ---------------------------------------------------------------------------
+void ForwardingModel::buildFibs()
+{
+    m_fib.reserve(m_routers.size());
+    m_hops.reserve(m_routers.size());
+
+    for (int r = 0; r < m_routers.size(); ++r) {
+        const auto &table = m_routers[r]->computedRoutingTable();
+
+        QList<PrefixRange> prefixes;
+        prefixes.reserve(table.size());
+        for (int i = 0; i < table.size(); ++i)
+            if (!table[i].isIpv6()) prefixes.append(rangeOf(table[i], i));
+        std::stable_sort(prefixes.begin(), prefixes.end(),
+                         [](const PrefixRange &a, const PrefixRange &b) {
+                             return a.first != b.first ? a.first < b.first : a.length < b.length;
+                         });
+
+        QList<quint64> boundaries;
+        boundaries.reserve(2 * prefixes.size());
+        for (const PrefixRange &p : prefixes) {
+            boundaries.append(p.first);
+            boundaries.append(quint64(p.last) + 1);
+        }
+        std::sort(boundaries.begin(), boundaries.end());
+        boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+        QList<FibRun> runs;
+        QList<PrefixRange> open;
+        int next = 0;
+        int lastClass = -1;
+        for (const quint64 boundary : boundaries) {
+            // The first class at or after the boundary; it starts later only
+            // when the gap before it is covered by no route at all
+            const int ec = static_cast<int>(
+                std::lower_bound(m_classes.cbegin(), m_classes.cend(), boundary,
+                                 [](const EquivalenceClass &c, quint64 a) { return c.first < a; })
+                - m_classes.cbegin());
+            if (ec == m_classes.size()) break;
+            if (ec == lastClass) continue;
+            lastClass = ec;
+
+            const quint32 at = m_classes[ec].first;
+            for (; next < prefixes.size() && prefixes[next].first <= at; ++next) {
+                const PrefixRange &p = prefixes[next];
+                if (p.last < at) continue;
+                while (!open.isEmpty() && open.last().last < p.first) open.removeLast();
+                // Duplicate prefix: the earlier table row wins (Connected before learned)
+                if (!open.isEmpty() && open.last().first == p.first && open.last().length == p.length)
+                    continue;
+                open.append(p);
+            }
+            while (!open.isEmpty() && open.last().last < at) open.removeLast();
+
+            const int entry = open.isEmpty() ? -1 : open.last().entry;
+            if (runs.isEmpty() ? entry >= 0 : runs.last().entry != entry)
+                runs.append({ec, entry});
+        }
+        m_fib.append(runs);
+    }
+
+    // Next hops depend only on the table row, not on the class
+    for (int r = 0; r < m_routers.size(); ++r) {
+        QList<Hop> hops;
+        const int rows = static_cast<int>(m_routers[r]->computedRoutingTable().size());
+        hops.reserve(rows);
+        for (int i = 0; i < rows; ++i)
+            hops.append(resolveHop(r, i));
+        m_hops.append(hops);
+    }
+}
+
+ForwardingModel::Hop ForwardingModel::resolveHop(int router, int entry) const
+{
+    const Router *r = m_routers[router];
+    const RoutingEntry &e = r->computedRoutingTable()[entry];
+
+    Hop hop;
+    if (e.nextHop == "directly connected") {
+        hop.kind = Hop::Deliver;
+        return hop;
+    }
+    if (e.exitInterface.isEmpty() || !r->getInterface(e.exitInterface))
+        return hop;
+
+    const quint32 nextHop = IpUtils::parse(e.nextHop);
+    for (const Endpoint &ep : segment(r, e.exitInterface)) {
+        const NetworkInterface *iface = ep.device->getInterface(ep.interfaceName);
+        if (!iface || !iface->hasIpAddress() || iface->ipAsUint32() != nextHop) continue;
+        if (auto *nbr = qobject_cast<Router *>(ep.device)) {
+            hop.kind = Hop::Forward;
+            hop.next = m_routerIndex.value(nbr->id(), -1);
+        }
+        break;
+    }
+    return hop;
+}
+
+// ---------------------------------------------------------------------------
+int ForwardingModel::fibEntry(int router, int ec) const
+{
+    const QList<FibRun> &runs = m_fib.at(router);
+    auto it = std::upper_bound(runs.cbegin(), runs.cend(), ec,
+                               [](int c, const FibRun &run) { return c < run.firstClass; });
+    return it == runs.cbegin() ? -1 : std::prev(it)->entry;
+}
+
+int ForwardingModel::classOf(quint32 address) const
+{
+    auto it = std::upper_bound(m_classes.cbegin(), m_classes.cend(), address,
+                               [](quint32 a, const EquivalenceClass &c) { return a < c.first; });
+    if (it == m_classes.cbegin()) return -1;
+    --it;
+    return (address <= it->last) ? static_cast<int>(it - m_classes.cbegin()) : -1;
+}
+
+QString ForwardingModel::describeClass(int ec) const
+{
+    const EquivalenceClass &c = m_classes.at(ec);
+    const quint64 size = quint64(c.last) - c.first + 1;
+    if ((size & (size - 1)) == 0 && (c.first & quint32(size - 1)) == 0) {
+        int len = 32;
+        for (quint64 s = size; s > 1; s >>= 1) --len;
+        return QString("%1/%2").arg(IpUtils::format(c.first)).arg(len);
+    }
+    return QString("%1 - %2").arg(IpUtils::format(c.first), IpUtils::format(c.last));
+}
+
+// ---------------------------------------------------------------------------
+// Trace one class from every router.  Each router is walked at most once:
+// a walk stops as soon as it reaches a router whose fate is already known.
+// ---------------------------------------------------------------------------
+QList<ForwardingModel::Resolution> ForwardingModel::resolveClass(int ec) const
+{
+    const int n = routerCount();
+    QList<Resolution> result(n);
+    QList<quint8>     state(n, 0); // 0 = new, 1 = on current walk, 2 = resolved
+    QList<int>        walk;
+
+    for (int start = 0; start < n; ++start) {
+        if (state[start] != 0) continue;
+
+        walk.clear();
+        Resolution outcome;
+        int cur = start;
+        for (;;) {
+            if (state[cur] == 2) { outcome = result[cur]; break; }
+            if (state[cur] == 1) { outcome = {Outcome::Loop, cur}; break; }
+            state[cur] = 1;
+            walk.append(cur);
+
+            const int entry = fibEntry(cur, ec);
+            if (entry < 0) { outcome = {Outcome::BlackHole, cur}; break; }
+
+            const Hop &hop = m_hops[cur][entry];
+            if (hop.kind == Hop::Deliver) { outcome = {Outcome::Delivered,   cur}; break; }
+            if (hop.kind == Hop::Dead)    { outcome = {Outcome::DeadNextHop, cur}; break; }
+            cur = hop.next;
+        }
+
+        for (int r : walk) {
+            result[r] = outcome;
+            state[r]  = 2;
+        }
+    }
+    return result;
+}
+
+QList<int> ForwardingModel::path(int router, int ec) const
+{
+    QList<int> hops;
+    QSet<int>  seen;
+    int cur = router;
+    while (cur >= 0) {
+        hops.append(cur);
+        if (seen.contains(cur)) break;
+        seen.insert(cur);
+
+        const int entry = fibEntry(cur, ec);
+        if (entry < 0) break;
+        const Hop &hop = m_hops[cur][entry];
+        if (hop.kind != Hop::Forward) break;
+        cur = hop.next;
+    }
+    return hops;
+}
+
+// ---------------------------------------------------------------------------
+// Segment discovery: follow the link on device/interfaceName and flood through
+// switches and hubs, collecting every layer-3 interface on the far side.
+// ---------------------------------------------------------------------------
+QList<ForwardingModel::Endpoint>
+ForwardingModel::segment(const Device *device, const QString &interfaceName) const
+{
+    const QString key = device->id() + "/" + interfaceName;
+    auto cached = m_segments.constFind(key);
+    if (cached != m_segments.constEnd()) return cached.value();
+
+    QList<Endpoint> endpoints;
+    QSet<QString>   visited{device->id()};
+    QQueue<QString> l2;
+
+    for (const Link *link : m_network->linksForDevice(device->id())) {
+        if (m_network->interfaceForLink(link, device->id()) != interfaceName) continue;
+        Device *nbr = m_network->neighbor(link, device->id());
+        if (!nbr) continue;
+        if (nbr->deviceType() == Device::Type::Switch || nbr->deviceType() == Device::Type::Hub)
+            l2.enqueue(nbr->id());
+        else
+            endpoints.append({nbr, m_network->interfaceForLink(link, nbr->id())});
+    }
+
+    while (!l2.isEmpty()) {
+        const QString current = l2.dequeue();
+        if (visited.contains(current)) continue;
+        visited.insert(current);
+
+        for (const Link *link : m_network->linksForDevice(current)) {
+            Device *nbr = m_network->neighbor(link, current);
+            if (!nbr || visited.contains(nbr->id())) continue;
+            if (nbr->deviceType() == Device::Type::Switch || nbr->deviceType() == Device::Type::Hub)
+                l2.enqueue(nbr->id());
+            else
+                endpoints.append({nbr, m_network->interfaceForLink(link, nbr->id())});
+        }
+    }
+
+    m_segments.insert(key, endpoints);
+    return endpoints;
+}
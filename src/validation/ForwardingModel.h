@@ -0,0 +1,96 @@
+#pragma once
+#include <QString>
+#include <QList>
+#include <QHash>
+
+class Network;
+class Device;
+class Router;
+
+// ---------------------------------------------------------------------------
+// ForwardingModel
+//
+// Read-only snapshot of the IPv4 data plane left behind by RoutingEngine::run
+// (IPv6 routes are ignored).  The IPv4 space covered by any computed route is cut into equivalence
+// classes: address ranges that match exactly the same prefixes on every
+// router, and are therefore forwarded identically.  Analyses trace one class
+// at a time instead of one address or one prefix at a time.
+// ---------------------------------------------------------------------------
+class ForwardingModel
+{
+public:
+    enum class Outcome : quint8 { Unresolved, Delivered, Loop, BlackHole, DeadNextHop };
+
+    struct EquivalenceClass {
+        quint32 first;
+        quint32 last;
+    };
+
+    // Where a packet of one class ends up when injected at a router.
+    struct Resolution {
+        Outcome outcome  = Outcome::Unresolved;
+        int     terminal = -1; // router index at which forwarding stopped
+    };
+
+    // A layer-3 interface reachable on a segment (possibly via switches/hubs).
+    struct Endpoint {
+        Device *device;
+        QString interfaceName;
+    };
+
+    explicit ForwardingModel(Network *network);
+
+    Network *network() const                { return m_network; }
+    int      routerCount() const            { return static_cast<int>(m_routers.size()); }
+    Router  *router(int index) const        { return m_routers.at(index); }
+    int      routerIndex(const QString &routerId) const { return m_routerIndex.value(routerId, -1); }
+
+    const QList<EquivalenceClass> &classes() const { return m_classes; }
+    int     classOf(quint32 address) const; // -1 when no route anywhere covers it
+    QString describeClass(int ec) const;    // "a.b.c.d/len" or "first - last"
+
+    // Index into router(r)->computedRoutingTable() of the longest-prefix
+    // match for class 'ec', or -1 when the router has no matching route.
+    // Binary search over the router's runs.
+    int fibEntry(int router, int ec) const;
+
+    // True when the route selected by fibEntry() terminates on a connected
+    // subnet of the router itself.
+    bool delivers(int router, int entry) const { return m_hops.at(router).at(entry).kind == Hop::Deliver; }
+
+    // Traces class 'ec' from every router in one pass, sharing the suffix of
+    // paths that merge.  Routers with no route for the class report BlackHole.
+    QList<Resolution> resolveClass(int ec) const;
+
+    // Witness path for class 'ec' starting at 'router'.  For a loop the
+    // first repeated router is appended once more to close the cycle.
+    QList<int> path(int router, int ec) const;
+
+    // Layer-3 endpoints on the segment attached to device/interfaceName,
+    // excluding the device itself.  Results are cached per interface.
+    QList<Endpoint> segment(const Device *device, const QString &interfaceName) const;
+
+private:
+    struct Hop {
+        enum Kind : quint8 { Deliver, Forward, Dead } kind = Dead;
+        int next = -1; // router index for Forward
+    };
+
+    // A router's FIB entry from firstClass up to the next run's firstClass
+    struct FibRun {
+        int firstClass;
+        int entry; // table index or -1
+    };
+
+    void buildClasses();
+    void buildFibs();
+    Hop  resolveHop(int router, int entry) const;
+
+    Network                     *m_network;
+    QList<Router *>              m_routers;
+    QHash<QString, int>          m_routerIndex;
+    QList<EquivalenceClass>      m_classes;
+    QList<QList<FibRun>>         m_fib;  // [router] -> runs by firstClass; -1 before the first
+    QList<QList<Hop>>            m_hops; // [router][table index]
+    mutable QHash<QString, QList<Endpoint>> m_segments;
+};
@@ -0,0 +1,346 @@
+#include "validation/ReachabilityMatrix.h"
+#include "validation/ForwardingModel.h"
+#include "models/Network.h"
+#include "utils/IpUtils.h"
+#include <QFile>
+#include <QDataStream>
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <algorithm>
+#include <numeric>
+
+static const quint32 FILE_MAGIC   = 0x4E455231; // "NER1"
+static const qint32  FILE_VERSION = 1;
+
+// ---------------------------------------------------------------------------
+// Word kernels.  Kept branch-free over contiguous words so the compiler can
+// vectorise them.
+// ---------------------------------------------------------------------------
+static inline void setBit(quint64 *row, int bit)
+{
+    row[bit >> 6] |= quint64(1) << (bit & 63);
+}
+
+// dst = direct | (routed & ~local)
+static void combineRow(quint64 *dst, const quint64 *direct, const quint64 *routed,
+                       const quint64 *local, int words)
+{
+    for (int i = 0; i < words; ++i)
+        dst[i] = direct[i] | (routed[i] & ~local[i]);
+}
+
+// ---------------------------------------------------------------------------
+// Broadcast domains: switches and hubs joined by links form one domain; a
+// router-to-router or router-to-PC link is a domain of its own.  Maps
+// "deviceId/interface" of every layer-3 interface to its domain.
+// ---------------------------------------------------------------------------
+static bool isLayer2(const Device *d)
+{
+    return d && (d->deviceType() == Device::Type::Switch || d->deviceType() == Device::Type::Hub);
+}
+
+static QHash<QString, int> broadcastDomains(Network *network)
+{
+    QHash<QString, int> l2Index;
+    for (const Device *d : network->devices())
+        if (isLayer2(d)) l2Index.insert(d->id(), static_cast<int>(l2Index.size()));
+
+    QList<int> parent(l2Index.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int x) {
+        while (parent[x] != x) { parent[x] = parent[parent[x]]; x = parent[x]; }
+        return x;
+    };
+
+    const QList<const Link *> links = network->links();
+    for (const Link *l : links) {
+        auto a = l2Index.constFind(l->device1Id);
+        auto b = l2Index.constFind(l->device2Id);
+        if (a != l2Index.constEnd() && b != l2Index.constEnd())
+            parent[find(a.value())] = find(b.value());
+    }
+
+    QHash<QString, int> domains;
+    int next = static_cast<int>(l2Index.size());
+    for (const Link *l : links) {
+        auto a = l2Index.constFind(l->device1Id);
+        auto b = l2Index.constFind(l->device2Id);
+        const bool l2a = a != l2Index.constEnd();
+        const bool l2b = b != l2Index.constEnd();
+        if (l2a && l2b) continue;
+        if (l2a)
+            domains.insert(l->device2Id + "/" + l->interface2, find(a.value()));
+        else if (l2b)
+            domains.insert(l->device1Id + "/" + l->interface1, find(b.value()));
+        else {
+            domains.insert(l->device1Id + "/" + l->interface1, next);
+            domains.insert(l->device2Id + "/" + l->interface2, next);
+            ++next;
+        }
+    }
+    return domains;
+}
+
+static qint64 pairKey(int a, quint32 b) { return (qint64(a) << 32) | b; }
+
+// ---------------------------------------------------------------------------
+// compute
+// ---------------------------------------------------------------------------
+ReachabilityMatrix ReachabilityMatrix::compute(Network *network)
+{
+    const ForwardingModel     model(network);
+    const QHash<QString, int> domains = broadcastDomains(network);
+
+    struct PcInfo {
+        quint32 ip      = 0;
+        quint32 mask    = 0;
+        int     domain  = -1;
+        int     gateway = -1; // router index
+        int     ec      = -1;
+    };
+
+    const QList<PC *> pcs = network->pcs();
+    QStringList ids, names;
+    for (const PC *pc : pcs) { ids.append(pc->id()); names.append(pc->name()); }
+
+    ReachabilityMatrix m;
+    m.reset(ids, names);
+    const int n = m.size();
+    const int W = m.m_words;
+
+    // (domain, ip) -> router owning that address, for gateway resolution
+    QHash<qint64, int> routerAt;
+    for (int r = 0; r < model.routerCount(); ++r) {
+        const Router *router = model.router(r);
+        for (const auto &iface : router->interfaces()) {
+            if (!iface.isConfigured()) continue;
+            const int dom = domains.value(router->id() + "/" + iface.name, -1);
+            if (dom >= 0) routerAt.insert(pairKey(dom, iface.ipAsUint32()), r);
+        }
+    }
+
+    QList<PcInfo> info(n);
+    for (int i = 0; i < n; ++i) {
+        const PC *pc = pcs[i];
+        if (pc->interfaces().isEmpty() || !pc->interfaces().first().isConfigured()) continue;
+        const NetworkInterface &eth = pc->interfaces().first();
+        PcInfo &p = info[i];
+        p.ip     = eth.ipAsUint32();
+        p.mask   = eth.maskAsUint32();
+        p.domain = domains.value(pc->id() + "/" + eth.name, -1);
+        p.ec     = model.classOf(p.ip);
+        if (p.domain >= 0 && !pc->defaultGateway().isEmpty())
+            p.gateway = routerAt.value(pairKey(p.domain, IpUtils::parse(pc->defaultGateway())), -1);
+    }
+
+    // PCs sorted by address, to find every PC inside a subnet by binary search
+    QList<int> byIp;
+    for (int i = 0; i < n; ++i) if (info[i].domain >= 0) byIp.append(i);
+    std::sort(byIp.begin(), byIp.end(), [&info](int a, int b) { return info[a].ip < info[b].ip; });
+
+    // -----------------------------------------------------------------------
+    // Routed rows: one per gateway router, over destination groups that share
+    // an equivalence class and a broadcast domain.
+    // -----------------------------------------------------------------------
+    QHash<int, int> gatewayRow; // router index -> row in 'routed'
+    for (const PcInfo &p : info)
+        if (p.gateway >= 0 && !gatewayRow.contains(p.gateway))
+            gatewayRow.insert(p.gateway, static_cast<int>(gatewayRow.size()));
+    QList<quint64> routed(qsizetype(gatewayRow.size()) * W, 0);
+
+    QHash<int, QHash<int, QList<int>>> destinations; // ec -> domain -> PCs
+    for (int i = 0; i < n; ++i)
+        if (info[i].ec >= 0 && info[i].domain >= 0)
+            destinations[info[i].ec][info[i].domain].append(i);
+
+    for (auto ecIt = destinations.cbegin(); ecIt != destinations.cend(); ++ecIt) {
+        const int ec = ecIt.key();
+        const QList<ForwardingModel::Resolution> res = model.resolveClass(ec);
+
+        for (auto g = gatewayRow.cbegin(); g != gatewayRow.cend(); ++g) {
+            const ForwardingModel::Resolution &rs = res[g.key()];
+            if (rs.outcome != ForwardingModel::Outcome::Delivered) continue;
+
+            const Router *last = model.router(rs.terminal);
+            const QString exitIface = last->computedRoutingTable()[model.fibEntry(rs.terminal, ec)].exitInterface;
+            const int dom = domains.value(last->id() + "/" + exitIface, -1);
+
+            quint64 *dst = routed.data() + qsizetype(g.value()) * W;
+            for (int pc : ecIt.value().value(dom))
+                setBit(dst, pc);
+        }
+    }
+
+    // -----------------------------------------------------------------------
+    // Source classes: PCs sharing domain, subnet and gateway get identical rows
+    // -----------------------------------------------------------------------
+    QList<quint64> zero(W, 0), direct(W), local(W), out(W);
+    QHash<QString, QList<int>> sourceClasses;
+    for (int i = 0; i < n; ++i) {
+        const PcInfo &p = info[i];
+        if (p.domain < 0) continue;
+        sourceClasses[QString("%1/%2/%3/%4").arg(p.domain).arg(p.ip & p.mask).arg(p.mask).arg(p.gateway)]
+            .append(i);
+    }
+
+    for (const QList<int> &members : sourceClasses) {
+        const PcInfo &p = info[members.first()];
+        const quint32 first = p.ip & p.mask;
+        const quint32 last  = first | ~p.mask;
+
+        std::fill(direct.begin(), direct.end(), 0);
+        std::fill(local.begin(),  local.end(),  0);
+        auto lo = std::lower_bound(byIp.cbegin(), byIp.cend(), first,
+                                   [&info](int pc, quint32 ip) { return info[pc].ip < ip; });
+        for (auto it = lo; it != byIp.cend() && info[*it].ip <= last; ++it) {
+            setBit(local.data(), *it);
+            if (info[*it].domain == p.domain) setBit(direct.data(), *it);
+        }
+
+        const quint64 *routedRow = p.gateway >= 0
+            ? routed.constData() + qsizetype(gatewayRow.value(p.gateway)) * W
+            : zero.constData();
+        combineRow(out.data(), direct.constData(), routedRow, local.constData(), W);
+
+        for (int pc : members) {
+            std::copy(out.cbegin(), out.cend(), m.row(pc));
+            setBit(m.row(pc), pc);
+        }
+    }
+    return m;
+}
+
+// ---------------------------------------------------------------------------
+void ReachabilityMatrix::reset(const QStringList &ids, const QStringList &names)
+{
+    m_ids   = ids;
+    m_names = names;
+    m_index.clear();
+    for (int i = 0; i < m_ids.size(); ++i) m_index.insert(m_ids[i], i);
+    m_words = static_cast<int>((m_ids.size() + 63) / 64);
+    m_bits  = QList<quint64>(qsizetype(m_ids.size()) * m_words, 0);
+}
+
+int ReachabilityMatrix::reachableCount(int from) const
+{
+    int count = 0;
+    const quint64 *r = row(from);
+    for (int i = 0; i < m_words; ++i) count += qPopulationCount(r[i]);
+    return count;
+}
+
+qint64 ReachabilityMatrix::reachablePairs() const
+{
+    qint64 count = 0;
+    for (quint64 w : m_bits) count += qPopulationCount(w);
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// Persistence
+// ---------------------------------------------------------------------------
+bool ReachabilityMatrix::save(const QString &filePath, QString *error) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out << FILE_MAGIC << FILE_VERSION << m_ids << m_names;
+
+    // Row words are written big-endian, like the rest of the stream, one row
+    // at a time through a swap buffer
+    QList<quint64> buffer(m_words);
+    for (int r = 0; r < size(); ++r) {
+        qToBigEndian<quint64>(row(r), m_words, buffer.data());
+        out.writeRawData(reinterpret_cast<const char *>(buffer.constData()),
+                         static_cast<int>(m_words * sizeof(quint64)));
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+bool ReachabilityMatrix::load(const QString &filePath, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    QDataStream in(&file);
+    quint32 magic = 0;
+    qint32  version = 0;
+    QStringList ids, names;
+    in >> magic >> version;
+    if (magic != FILE_MAGIC || version != FILE_VERSION) {
+        if (error) *error = "Not a reachability matrix file.";
+        return false;
+    }
+    in >> ids >> names;
+    if (in.status() != QDataStream::Ok || ids.size() != names.size()) {
+        if (error) *error = "Corrupt reachability matrix file.";
+        return false;
+    }
+    reset(ids, names);
+    const qint64 bytes = m_bits.size() * qint64(sizeof(quint64));
+    if (in.readRawData(reinterpret_cast<char *>(m_bits.data()), static_cast<int>(bytes)) != bytes) {
+        if (error) *error = "Truncated reachability matrix file.";
+        reset({}, {});
+        return false;
+    }
+    qFromBigEndian<quint64>(m_bits.constData(), m_bits.size(), m_bits.data());
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Diff: XOR whole rows when both matrices list the same PCs in the same
+// order, otherwise compare bit by bit through the id mapping.  PCs in only
+// one matrix are listed as added or removed; their pairs are not counted.
+// ---------------------------------------------------------------------------
+ReachabilityDiff ReachabilityMatrix::diff(const ReachabilityMatrix &before,
+                                          const ReachabilityMatrix &after,
+                                          int maxPairs)
+{
+    ReachabilityDiff d;
+    auto record = [&](int src, int dst, bool nowReachable) {
+        const QPair<QString, QString> pair(after.m_names[src], after.m_names[dst]);
+        if (nowReachable) {
+            if (d.gained++ < maxPairs) d.gainedPairs.append(pair);
+        } else {
+            if (d.lost++ < maxPairs) d.lostPairs.append(pair);
+        }
+    };
+
+    if (before.m_ids == after.m_ids) {
+        for (int s = 0; s < after.size(); ++s) {
+            const quint64 *a = before.row(s);
+            const quint64 *b = after.row(s);
+            for (int w = 0; w < after.m_words; ++w) {
+                for (quint64 x = a[w] ^ b[w]; x; x &= x - 1) {
+                    const int bit = w * 64 + qCountTrailingZeroBits(x);
+                    record(s, bit, (b[w] >> (bit & 63)) & 1u);
+                }
+            }
+        }
+        return d;
+    }
+
+    QList<int> map(after.size(), -1); // after index -> before index
+    for (int i = 0; i < after.size(); ++i) {
+        map[i] = before.indexOf(after.m_ids[i]);
+        if (map[i] < 0) d.addedPcs.append(after.m_names[i]);
+    }
+    for (int i = 0; i < before.size(); ++i)
+        if (after.indexOf(before.m_ids[i]) < 0) d.removedPcs.append(before.m_names[i]);
+
+    for (int s = 0; s < after.size(); ++s) {
+        const int bs = map[s];
+        if (bs < 0) continue;
+        for (int t = 0; t < after.size(); ++t) {
+            if (map[t] < 0) continue;
+            const bool now = after.reachable(s, t);
+            if (now != before.reachable(bs, map[t])) record(s, t, now);
+        }
+    }
+    return d;
+}
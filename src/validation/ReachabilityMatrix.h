@@ -0,0 +1,64 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QPair>
+
+class Network;
+
+struct ReachabilityDiff {
+    qint64 gained = 0;
+    qint64 lost   = 0;
+    QList<QPair<QString, QString>> gainedPairs; // (source PC name, destination PC name)
+    QList<QPair<QString, QString>> lostPairs;   // capped at the maxPairs given to diff()
+    QStringList addedPcs;   // names of PCs only in the newer matrix
+    QStringList removedPcs; // names of PCs only in the older matrix
+};
+
+// ---------------------------------------------------------------------------
+// ReachabilityMatrix
+//
+// N x N "can PC A deliver a packet to PC B" matrix derived from the computed
+// routing tables.  Rows are packed bitsets (64 destinations per word), so a
+// 20k-PC network takes about 50 MB.
+// ---------------------------------------------------------------------------
+class ReachabilityMatrix
+{
+public:
+    // RoutingEngine::run must have been called so routers carry their tables.
+    static ReachabilityMatrix compute(Network *network);
+
+    int  size() const                        { return static_cast<int>(m_ids.size()); }
+    const QStringList &pcIds()   const       { return m_ids; }
+    const QStringList &pcNames() const       { return m_names; }
+    int  indexOf(const QString &pcId) const  { return m_index.value(pcId, -1); }
+
+    bool reachable(int from, int to) const
+    {
+        return (row(from)[to >> 6] >> (to & 63)) & 1u;
+    }
+    int    reachableCount(int from) const; // destinations reachable from one PC
+    qint64 reachablePairs() const;
+
+    // Binary export: PC ids and names followed by the row words, big-endian.
+    bool save(const QString &filePath, QString *error = nullptr) const;
+    bool load(const QString &filePath, QString *error = nullptr);
+
+    // Pairs reachable in one matrix but not the other, matched by PC id, and
+    // the PCs present in only one of them.
+    static ReachabilityDiff diff(const ReachabilityMatrix &before,
+                                 const ReachabilityMatrix &after,
+                                 int maxPairs = 1000);
+
+private:
+    void reset(const QStringList &ids, const QStringList &names);
+    const quint64 *row(int r) const { return m_bits.constData() + qsizetype(r) * m_words; }
+    quint64       *row(int r)       { return m_bits.data() + qsizetype(r) * m_words; }
+
+    QStringList         m_ids;
+    QStringList         m_names;
+    QHash<QString, int> m_index;
+    int                 m_words = 0; // words per row
+    QList<quint64>      m_bits;
+};
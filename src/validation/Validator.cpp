@@ -1,5 +1,6 @@
 #include "validation/Validator.h"
 #include "models/Network.h"
+#include "utils/Trace.h"
 #include "utils/IpUtils.h"
 #include <QSet>
 #include <QQueue>
@@ -7,9 +8,11 @@
 // ---------------------------------------------------------------------------
 QList<ValidationIssue> Validator::validate(Network *network)
 {
+    TRACE_SCOPE("Validator::validate");
     QList<ValidationIssue> issues;
     checkIpConflicts(network, issues);
     checkSubnetMismatches(network, issues);
+    checkIpv6Addressing(network, issues);
     checkPcGateways(network, issues);
     checkOspfRouterIds(network, issues);
     checkUnconnectedInterfaces(network, issues);
@@ -23,24 +26,17 @@ QList<ValidationIssue> Validator::validate(Network *network)
 // ---------------------------------------------------------------------------
 void Validator::checkIpConflicts(Network *network, QList<ValidationIssue> &issues)
 {
-    QHash<QString, QStringList> ipToDevices; // ip -> list of device names
-
-    for (const auto *dev : network->devices()) {
-        for (const auto &iface : dev->interfaces()) {
-            if (!iface.isConfigured()) continue;
-            ipToDevices[iface.ipAddress].append(
-                QString("%1 (%2)").arg(dev->name(), iface.name));
-        }
-    }
-
-    for (auto it = ipToDevices.constBegin(); it != ipToDevices.constEnd(); ++it) {
-        if (it.value().size() > 1) {
-            ValidationIssue issue;
-            issue.severity = ValidationIssue::Severity::Error;
-            issue.message  = QString("IP address conflict: %1 is assigned to: %2")
-                                 .arg(it.key(), it.value().join(", "));
-            issues.append(issue);
-        }
+    // The network's address index already tracks addresses with several owners
+    for (const quint32 address : network->conflictingAddresses()) {
+        QStringList owners;
+        for (const Network::InterfaceRef &ref : network->addressOwners(address))
+            owners << QString("%1 (%2)").arg(ref.device->name(), ref.iface().name);
+
+        ValidationIssue issue;
+        issue.severity = ValidationIssue::Severity::Error;
+        issue.message  = QString("IP address conflict: %1 is assigned to: %2")
+                             .arg(IpUtils::format(address), owners.join(", "));
+        issues.append(issue);
     }
 }
 
@@ -66,12 +62,55 @@ void Validator::checkSubnetMismatches(Network *network, QList<ValidationIssue> &
         quint32 net1 = if1->networkAddr();
         quint32 net2 = if2->networkAddr();
 
-        if (net1 != net2 || if1->subnetMask != if2->subnetMask) {
+        if (net1 != net2 || if1->maskAsUint32() != if2->maskAsUint32()) {
             ValidationIssue issue;
             issue.severity = ValidationIssue::Severity::Error;
             issue.message  = QString("Subnet mismatch on link %1 (%2: %3/%4) <-> %5 (%6: %7/%8)")
-                                 .arg(d1->name(), if1->name, if1->ipAddress, if1->subnetMask,
-                                      d2->name(), if2->name, if2->ipAddress, if2->subnetMask);
+                                 .arg(d1->name(), if1->name, if1->ipAddress(), if1->subnetMask(),
+                                      d2->name(), if2->name, if2->ipAddress(), if2->subnetMask());
+            issue.deviceIds << d1->id() << d2->id();
+            issues.append(issue);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// IPv6: duplicate addresses, and links whose ends are on different prefixes
+// ---------------------------------------------------------------------------
+void Validator::checkIpv6Addressing(Network *network, QList<ValidationIssue> &issues)
+{
+    QHash<IpUtils::Ip6Address, QStringList> ipToDevices;
+    for (const auto *dev : network->devices()) {
+        for (const auto &iface : dev->interfaces()) {
+            if (!iface.hasIpv6()) continue;
+            ipToDevices[iface.ipv6()].append(QString("%1 (%2)").arg(dev->name(), iface.name));
+        }
+    }
+    for (auto it = ipToDevices.constBegin(); it != ipToDevices.constEnd(); ++it) {
+        if (it.value().size() > 1) {
+            ValidationIssue issue;
+            issue.severity = ValidationIssue::Severity::Error;
+            issue.message  = QString("IPv6 address conflict: %1 is assigned to: %2")
+                                 .arg(IpUtils::format6(it.key()), it.value().join(", "));
+            issues.append(issue);
+        }
+    }
+
+    for (const Link *link : network->links()) {
+        const Device *d1 = network->device(link->device1Id);
+        const Device *d2 = network->device(link->device2Id);
+        if (!d1 || !d2) continue;
+
+        const NetworkInterface *if1 = d1->getInterface(link->interface1);
+        const NetworkInterface *if2 = d2->getInterface(link->interface2);
+        if (!if1 || !if2 || !if1->hasIpv6() || !if2->hasIpv6()) continue;
+
+        if (if1->ipv6PrefixLen() != if2->ipv6PrefixLen() || if1->ipv6Network() != if2->ipv6Network()) {
+            ValidationIssue issue;
+            issue.severity = ValidationIssue::Severity::Error;
+            issue.message  = QString("IPv6 prefix mismatch on link %1 (%2: %3) <-> %4 (%5: %6)")
+                                 .arg(d1->name(), if1->name, if1->ipv6Address(),
+                                      d2->name(), if2->name, if2->ipv6Address());
             issue.deviceIds << d1->id() << d2->id();
             issues.append(issue);
         }
@@ -83,9 +122,7 @@ void Validator::checkSubnetMismatches(Network *network, QList<ValidationIssue> &
 // ---------------------------------------------------------------------------
 void Validator::checkPcGateways(Network *network, QList<ValidationIssue> &issues)
 {
-    for (const auto *dev : network->devices()) {
-        const PC *pc = qobject_cast<const PC *>(dev);
-        if (!pc) continue;
+    for (const PC *pc : network->pcs()) {
         if (!pc->interfaces().first().isConfigured()) continue;
 
         if (pc->defaultGateway().isEmpty()) {
@@ -99,12 +136,12 @@ void Validator::checkPcGateways(Network *network, QList<ValidationIssue> &issues
 
         // Gateway must be on the same subnet
         const NetworkInterface &eth = pc->interfaces().first();
-        if (!IpUtils::sameSubnet(pc->ipAddress(), pc->defaultGateway(), eth.subnetMask)) {
+        if ((IpUtils::parse(pc->defaultGateway()) & eth.maskAsUint32()) != eth.networkAddr()) {
             ValidationIssue issue;
             issue.severity = ValidationIssue::Severity::Error;
             issue.message  = QString("PC '%1': default gateway %2 is not on the same subnet as %3/%4.")
                                  .arg(pc->name(), pc->defaultGateway(),
-                                      pc->ipAddress(), eth.subnetMask);
+                                      pc->ipAddress(), eth.subnetMask());
             issue.deviceIds << pc->id();
             issues.append(issue);
         }
@@ -118,8 +155,7 @@ void Validator::checkOspfRouterIds(Network *network, QList<ValidationIssue> &iss
 {
     QHash<QString, QStringList> ridToRouters;
 
-    for (auto *router : network->routers()) {
-        if (router->routingProtocol() != Router::RoutingProtocol::OSPF) continue;
+    for (auto *router : network->routers(Router::RoutingProtocol::OSPF)) {
         const QString rid = router->ospfConfig().routerId;
         if (!rid.isEmpty())
             ridToRouters[rid].append(router->name());
@@ -148,7 +184,7 @@ void Validator::checkUnconnectedInterfaces(Network *network, QList<ValidationIss
                 ValidationIssue issue;
                 issue.severity = ValidationIssue::Severity::Warning;
                 issue.message  = QString("'%1' interface %2 (%3) is configured but not connected.")
-                                     .arg(dev->name(), iface.name, iface.ipAddress);
+                                     .arg(dev->name(), iface.name, iface.ipAddress());
                 issue.deviceIds << dev->id();
                 issues.append(issue);
             }
@@ -161,8 +197,7 @@ void Validator::checkUnconnectedInterfaces(Network *network, QList<ValidationIss
 // ---------------------------------------------------------------------------
 void Validator::checkRipNetworks(Network *network, QList<ValidationIssue> &issues)
 {
-    for (auto *router : network->routers()) {
-        if (router->routingProtocol() != Router::RoutingProtocol::RIPv2) continue;
+    for (auto *router : network->routers(Router::RoutingProtocol::RIPv2)) {
         if (router->ripv2Config().networks.isEmpty()) {
             ValidationIssue issue;
             issue.severity = ValidationIssue::Severity::Warning;
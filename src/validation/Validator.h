@@ -30,6 +30,7 @@ public:
 private:
     static void checkIpConflicts(Network *network, QList<ValidationIssue> &issues);
     static void checkSubnetMismatches(Network *network, QList<ValidationIssue> &issues);
+    static void checkIpv6Addressing(Network *network, QList<ValidationIssue> &issues);
     static void checkPcGateways(Network *network, QList<ValidationIssue> &issues);
     static void checkOspfRouterIds(Network *network, QList<ValidationIssue> &issues);
     static void checkUnconnectedInterfaces(Network *network, QList<ValidationIssue> &issues);